@@ -50,6 +50,15 @@ int main(int ac,char *av[]) {
 
 	bool fast = false;
 
+	int threads = 1;
+
+	bool profile = false;
+
+	bool blocking = false;
+
+	int prefetch_rows = DEFAULT_PREFETCH_ROWS_AHEAD;
+	int prefetch_targets = DEFAULT_PREFETCH_TARGETS_AHEAD;
+
 	int errcode = 0;
 
 
@@ -60,6 +69,11 @@ int main(int ac,char *av[]) {
             ("help", "produce help message")
             ("simtime", po::value<double>(), "simulation time")
             ("fast", "turns off most monitoring to reduce IO")
+            ("threads", po::value<int>(), "number of threads per rank")
+            ("profile", "print a per-object profile at the end of the run")
+            ("blocking", "use temporal blocking (requires --fast)")
+            ("prefetch_rows", po::value<int>(), "spikes to look ahead when prefetching rows (0 disables)")
+            ("prefetch_targets", po::value<int>(), "synapses to look ahead when prefetching targets (0 disables)")
             ("dir", po::value<string>(), "load/save directory")
             ("fee", po::value<string>(), "file with EE connections")
             ("fei", po::value<string>(), "file with EI connections")
@@ -84,6 +98,26 @@ int main(int ac,char *av[]) {
 			fast = true;
         } 
 
+        if (vm.count("threads")) {
+			threads = vm["threads"].as<int>();
+        } 
+
+        if (vm.count("profile")) {
+			profile = true;
+        } 
+
+        if (vm.count("blocking")) {
+			blocking = true;
+        } 
+
+        if (vm.count("prefetch_rows")) {
+			prefetch_rows = vm["prefetch_rows"].as<int>();
+        } 
+
+        if (vm.count("prefetch_targets")) {
+			prefetch_targets = vm["prefetch_targets"].as<int>();
+        } 
+
         if (vm.count("dir")) {
 			dir = vm["dir"].as<string>();
         } 
@@ -127,6 +161,11 @@ int main(int ac,char *av[]) {
 	logger = new Logger(logfile.str(),world.rank(),PROGRESS,EVERYTHING);
 
 	sys = new System(&world);
+	if ( threads > 1 ) sys->set_num_threads(threads);
+	if ( profile ) sys->set_profiling(true, outputfile+"prof");
+	if ( blocking ) sys->set_temporal_blocking(true);
+	SparseConnection::prefetch_rows_ahead = prefetch_rows;
+	SparseConnection::prefetch_targets_ahead = prefetch_targets;
 	// END Global stuff
 
 	logger->msg("Setting up neuron groups ...",PROGRESS,true);
@@ -134,11 +134,69 @@ void AIF2Group::check_thresholds()
 
 }
 
+void AIF2Group::evolve_fused(NeuronID begin, NeuronID end)
+{
+	const AurynFloat mul_nmda = dt/tau_nmda;
+	const AurynFloat mul_tau_mem = dt/tau_mem;
+	unsigned char spike_flags[FUSED_KERNEL_BLOCK_SIZE];
+
+	AurynState * const mem_ptr = mem->data;
+	AurynState * const thr_ptr = thr->data;
+	AurynState * const ampa_ptr = g_ampa->data;
+	AurynState * const gaba_ptr = g_gaba->data;
+	AurynState * const nmda_ptr = g_nmda->data;
+	AurynState * const adapt1_ptr = g_adapt1->data;
+	AurynState * const adapt2_ptr = g_adapt2->data;
+
+	// same order of operations as in the vectorized version
+#pragma GCC ivdep // the state vectors never overlap
+	for ( NeuronID i = begin ; i < end ; ++i ) {
+		const AurynState ampa = ampa_ptr[i]*scale_ampa;
+		const AurynState gaba = gaba_ptr[i]*scale_gaba;
+		const AurynState adapt1 = adapt1_ptr[i]*scale_adapt1;
+		const AurynState adapt2 = adapt2_ptr[i]*scale_adapt2;
+		AurynState nmda = nmda_ptr[i];
+		nmda = mul_nmda*ampa + nmda;
+		nmda = -mul_nmda*nmda + nmda;
+
+		AurynState v = mem_ptr[i];
+		const AurynState exc = ( -A_nmda*nmda + ampa*(-A_ampa) ) * v;
+		const AurynState inh = ( v - e_rev ) * ( adapt2 + ( adapt1 + gaba ) );
+		const AurynState leak = v - e_rest;
+
+		v = mul_tau_mem*exc + v;
+		v = -mul_tau_mem*inh + v;
+		v = -mul_tau_mem*leak + v;
+		v = v < 0 ? v : 0;
+		v = v > e_rev ? v : e_rev;
+
+		// threshold check and reset without branches
+		const AurynState th = thr_ptr[i]*scale_thr;
+		const bool spike = v > ( thr_rest + th );
+		spike_flags[i-begin] = spike;
+
+		ampa_ptr[i] = ampa;
+		gaba_ptr[i] = gaba;
+		nmda_ptr[i] = nmda;
+		thr_ptr[i] = spike ? dthr : th; // refractory
+		mem_ptr[i] = spike ? e_rest : v; // reset
+		adapt1_ptr[i] = spike ? adapt1 + dg_adapt1 : adapt1;
+		adapt2_ptr[i] = spike ? adapt2 + dg_adapt2 : adapt2;
+	}
+
+	push_spikes(spike_flags, begin, end);
+}
+
 void AIF2Group::evolve()
 {
+#ifdef CODE_USE_FUSED_NEURON_KERNELS
+	for ( NeuronID i = 0 ; i < get_rank_size() ; i += FUSED_KERNEL_BLOCK_SIZE ) 
+		evolve_fused(i, std::min(i+FUSED_KERNEL_BLOCK_SIZE, get_rank_size()));
+#else
 	integrate_linear_nmda_synapses();
 	integrate_membrane();
 	check_thresholds();
+#endif /* CODE_USE_FUSED_NEURON_KERNELS */
 }
 
 
@@ -46,6 +46,9 @@ protected:
 	void calculate_scale_constants();
 	void integrate_linear_nmda_synapses();
 	void check_thresholds();
+	/*! Single pass version of integrate_linear_nmda_synapses, 
+	 * integrate_membrane and check_thresholds for neurons [begin:end). */
+	void evolve_fused(NeuronID begin, NeuronID end);
 
 public:
 	AIF2Group( NeuronID size, AurynFloat load = 1.0, NeuronID total = 0 );
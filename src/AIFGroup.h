@@ -58,6 +58,10 @@ protected:
 	void integrate_linear_nmda_synapses();
 	void integrate_membrane();
 	void check_thresholds();
+	/*! Integrates synapses and membrane and checks thresholds for neurons
+	 * [begin:end) in a single pass. Equivalent to the three methods above
+	 * but does not update t_leak, t_exc and t_inh. */
+	void evolve_fused(NeuronID begin, NeuronID end);
 public:
 	AurynFloat dg_adapt1;
 
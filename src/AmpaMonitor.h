@@ -48,6 +48,8 @@ public:
 	AmpaMonitor(NeuronGroup * source, NeuronID id, string filename, AurynTime stepsize=1);
 	virtual ~AmpaMonitor();
 	void propagate();
+	/*! Follows the recorded neuron when its group is renumbered */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
 };
 
 #endif /*AMPAMONITOR_H_*/
@@ -93,13 +93,19 @@ void BinarySpikeMonitor::propagate()
 {
 	struct spikeEvent_type spikeData;
 	for (it = src->get_spikes_immediate()->begin() ; it < src->get_spikes_immediate()->end() ; ++it ) {
-		if (*it >= n_from ) {
-			if ( *it < n_to && (*it%n_every==0) )
+		const NeuronID id = src->get_original_id(*it);
+		if (id >= n_from ) {
+			if ( id < n_to && (id%n_every==0) )
             {
                 spikeData.time = dt*(sys->get_clock());
-                spikeData.neuronID = (*it + offset);
+                spikeData.neuronID = (id + offset);
                 outfile.write((char*)&spikeData, sizeof(spikeEvent_type));
             }
 		}
 	}
 }
+
+SpikingGroup * BinarySpikeMonitor::get_source()
+{
+	return src;
+}
@@ -63,6 +63,7 @@ public:
 	void set_every(NeuronID every);
 	virtual ~BinarySpikeMonitor();
 	void propagate();
+	virtual SpikingGroup * get_source();
 };
 
 #endif /*BINARYSPIKEMONITOR_H_*/
@@ -33,3 +33,8 @@ Checker::Checker(SpikingGroup * source)
 Checker::~Checker()
 {
 }
+
+SpikingGroup * Checker::get_source()
+{
+	return src;
+}
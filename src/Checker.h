@@ -61,6 +61,8 @@ public:
 	 * is enabled will stop the current run.
 	 */
 	virtual AurynFloat get_property() = 0 ;
+	/*! Returns the SpikingGroup this Checker is watching */
+	SpikingGroup * get_source();
 };
 
 #endif /*CHECKER_H_*/
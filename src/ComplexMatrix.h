@@ -28,6 +28,7 @@
 
 #include "auryn_global.h"
 #include "auryn_definitions.h"
+#include "SimpleMatrix.h"
 #include <string.h>
 
 #include <boost/serialization/utility.hpp>
@@ -72,7 +73,8 @@ private:
 			// data
 			for (StateID z = 0; z < z_values ; ++z ) {
 				for (AurynLong i = 0 ; i < n_nonzero ; ++i) {
-					ar & elementdata[i+z*statesize];
+					T value = ( elementdata == NULL ) ? uniform_value : elementdata[i+z*statesize];
+					ar & value;
 				}
 			}
 		}
@@ -89,6 +91,9 @@ private:
 
 			// allocate necessary memory
 			resize_buffer(statesize);
+			expand_uniform();
+			col_index_valid = false;
+			local_index_valid = false;
 
 			// rowpointers -- translate in elements per row
 			for ( NeuronID i = 0 ; i < m_rows+1 ; ++i ) {
@@ -119,12 +124,41 @@ private:
 	AurynLong n_nonzero;
 	/*! The size of data reserved and therefore the maximum number of non-zero elements. */
 	AurynLong statesize;
+	/*! Transposed index with one row per column of this matrix. Its column 
+	 * indices are the row indices of the elements and its data are the 
+	 * offsets of the elements in elementdata. Built on demand by build_col_index(). */
+	SimpleMatrix<AurynInt> * col_index;
+	/*! Flag that is cleared whenever the sparsity structure changes. */
+	bool col_index_valid;
+	/*! Rank local column indices as 16 bit integers. NULL if they have 
+	 * not been requested or did not fit. Built on demand by get_local_index(). */
+	unsigned short * local_colinds;
+	/*! Divisor with which local_colinds were computed */
+	NeuronID local_index_divisor;
+	/*! Flag that is cleared whenever the sparsity structure changes. */
+	bool local_index_valid;
+	/*! The value of all elements while the matrix is uniform (elementdata is NULL). */
+	T uniform_value;
+	/*! Set once pointers into elementdata have been handed out. */
+	bool data_exposed;
+
+	/*! Returns the pointer to the column index of element (i,j) or NULL if it does not exist. */
+	NeuronID * find_element(NeuronID i, NeuronID j);
+	/*! Called by all methods which return pointers into elementdata. Expands
+	 * a uniform matrix and prevents that it is compressed again, since the 
+	 * pointers might still be in use. */
+	void expose_data() 
+	{
+		expand_uniform();
+		data_exposed = true;
+	}
 protected:
 	/*! Array that holds the begin addresses of column indices */
 	NeuronID ** rowptrs;
 	/*! Array that holds the column indices of non-zero elements */
 	NeuronID * colinds;
-	/*! Array that holds the data values of the non-zero elements */
+	/*! Array that holds the data values of the non-zero elements. It is 
+	 * NULL while the matrix is uniform (see compress_uniform). */
 	T * elementdata; 
 
 	/*! Default initializiation called by the constructor. */
@@ -141,7 +175,9 @@ public:
 
 	/*! Resize buffer
 	 *  Allocates a new buffer of size and copies the 
-	 *  old buffers before freeing the memory */
+	 *  old buffers before freeing the memory. Each state is copied 
+	 *  separately since its offset in elementdata scales with the buffer size.
+	 * \throw AurynMatrixBufferException if size is smaller than the number of nonzero elements */
 	void resize_buffer(AurynLong size);
 
 	/*! Resizes buffer and clears the matrix. This saves
@@ -171,10 +207,55 @@ public:
 	/*! Gets the matching data value for a given index pointer and state z*/
 	T get_data(const NeuronID * ind_ptr, StateID z=0);
 	void fill_zeros();
+	/*! \brief Frees the data array if all elements have the same value
+	 *
+	 * The matrix then only keeps the column indices and a single value. All 
+	 * methods keep working and a uniform matrix is transparently expanded 
+	 * again when an element is set to a different value or when a pointer into
+	 * the data is requested (get_data_begin, get_ptr, ...). Once such a pointer 
+	 * has been handed out the matrix is not compressed anymore. 
+	 * Only matrices with a single synaptic state can be compressed.
+	 * \return true if the matrix is uniform */
+	bool compress_uniform();
+	/*! Reallocates the data array of a uniform matrix and fills it with the uniform value. */
+	void expand_uniform();
+	/*! Returns true if the matrix only stores a single value for all elements (see compress_uniform) */
+	bool is_uniform();
+	/*! Returns the value of all elements of a uniform matrix. */
+	T get_uniform_value();
+	/*! Lays out the rows of a cleared matrix such that row i holds sizes[i] 
+	 * elements and marks the matrix as filled. The column indices and values
+	 * then have to be written by the caller through get_ind_begin() and 
+	 * get_data_begin(z) in ascending column order within each row. This allows
+	 * to fill a matrix in bulk, e.g. when loading it from a binary file.
+	 * \param sizes Array with the number of elements of each of the m_rows rows
+	 * \throw AurynMatrixBufferException */
+	void set_row_sizes(const AurynLong * sizes);
+	/*! Like set_row_sizes, but appends the rows lo to hi-1 with sizes[i-lo] 
+	 * elements each behind the elements that have been pushed so far. Rows 
+	 * between the last filled row and lo remain empty. The column indices and
+	 * values of the new rows have to be written by the caller through 
+	 * get_row_begin(i) and get_data_ptr(get_row_begin(i)).
+	 * \param lo First row to append. Has to be larger than the last row that 
+	 * contains elements.
+	 * \param hi Row behind the last row to append
+	 * \param sizes Array with the number of elements of each of the hi-lo rows
+	 * \throw AurynMatrixPushBackException
+	 * \throw AurynMatrixBufferException */
+	void append_row_sizes(NeuronID lo, NeuronID hi, const AurynLong * sizes);
+	/*! \brief Renumbers rows and columns
+	 *
+	 * Moves element (i,j) to (row_ids[i],col_ids[j]) and sorts the elements
+	 * of each row by their new column. The values of all synaptic states are 
+	 * moved along. The matrix keeps its buffers, such that pointers into the 
+	 * data stay valid, however they then point to different elements.
+	 * \param row_ids New index of each row or NULL to keep the rows
+	 * \param col_ids New index of each column or NULL to keep the columns */
+	void permute(const vector<NeuronID> * row_ids, const vector<NeuronID> * col_ids);
 	AurynDouble get_fill_level();
 	T get(NeuronID i, NeuronID j, NeuronID z=0);
 	bool exists(NeuronID i, NeuronID j);
-	/*! Returns the pointer to a particular element */
+	/*! Returns the pointer to a particular element or NULL if it does not exist */
 	T * get_ptr(NeuronID i, NeuronID j);
 	T * get_ptr(NeuronID i, NeuronID j, NeuronID z);
 	/*! Returns the pointer to a particular element given 
@@ -207,6 +288,8 @@ public:
 	T get_value(AurynLong data_index);
 	void add_value(AurynLong data_index, T value);
 	NeuronID get_colind(AurynLong data_index);
+	/*! Returns the row of the element at data_index by bisection of the row pointers */
+	NeuronID get_rowind(AurynLong data_index);
 	bool set(NeuronID i, NeuronID j, T value);
 	/*! Sets all non-zero elements to value */
 	void set_all(T value);
@@ -216,11 +299,46 @@ public:
 	void scale_row(NeuronID i, T value);
 	/*! Scales all non-zero elements */
 	void scale_all(T value);
-	/*! Sets all non-zero elements in col j to value. Due to ordering this is slow and the use of this functions is discouraged. */
+	/*! Builds the transposed index used by the column operations below.
+	 * This is a counting sort over the column indices and therefore linear in
+	 * the number of non-zero elements. It is called automatically by the
+	 * column operations whenever the sparsity structure has changed since the
+	 * last call, so there is usually no need to call it by hand.
+	 * \throw AurynMatrixBufferException */
+	void build_col_index();
+	/*! Returns the transposed index, which has one row per column j. 
+	 * The row indices of the elements in column j are found between 
+	 * get_row_begin(j) and get_row_end(j) of the index and the offsets of the 
+	 * respective elements in the data array in its data. */
+	SimpleMatrix<AurynInt> * get_col_index();
+	/*! \brief Returns the column indices divided by divisor as 16 bit integers
+	 *
+	 * The array is aligned with the data array, i.e. the local index of the 
+	 * element with data index k is found at position k. With the locked range of 
+	 * the postsynaptic group as divisor these are the rank local neuron ids which
+	 * SpikingGroup::global2rank would compute. The array is built on the first 
+	 * call and rebuilt after the sparsity structure has changed. The global column
+	 * indices are kept, such that all other methods are unaffected.
+	 * \return Pointer to the local indices or NULL if one of them does not fit 
+	 * into 16 bits. */
+	unsigned short * get_local_index(NeuronID divisor);
+	/*! Sets all non-zero elements in col j to value. */
 	void set_col(NeuronID j, T value);
-	/*! Scales all non-zero elements in col j to value. Due to ordering this is slow and the use of this functions is discouraged. */
+	/*! Scales all non-zero elements in col j to value. */
 	void scale_col(NeuronID j, T value);
+	/*! Returns the sum over all non-zero elements in col j. */
 	double sum_col(NeuronID j);
+	/*! Scales the non-zero elements in col j such that they sum up to target. 
+	 * Columns which are empty or sum up to zero are left unchanged. */
+	void normalize_col(NeuronID j, T target);
+	/*! Clips all non-zero elements in col j to the interval [lo,hi]. */
+	void clip_col(NeuronID j, T lo, T hi);
+	/*! Scales each column such that its non-zero elements sum up to target.
+	 * Columns which are empty or sum up to zero are left unchanged. The column 
+	 * sums are accumulated in a single pass over the data in storage order and 
+	 * a second pass applies the scale factors, so this does not need the 
+	 * transposed index. */
+	void normalize_cols(T target);
 	/*! Returns datasize: number of possible entries */
 	AurynLong get_datasize();
 	/*! Same as datasize : number of possible entries */
@@ -234,6 +352,10 @@ public:
 	double mean();
 	NeuronID * get_ind_begin();
 	NeuronID * get_row_begin(NeuronID i);
+	/*! Hints the CPU to load the beginning of row i, i.e. its first column 
+	 * indices, local indices (see get_local_index) and values of state z,
+	 * into cache. Only has an effect with CODE_ACTIVATE_PREFETCHING_INTRINSICS. */
+	void prefetch_row(NeuronID i, StateID z=0);
 	AurynLong get_row_begin_index(NeuronID i);
 	NeuronID * get_row_end(NeuronID i);
 	AurynLong get_row_end_index(NeuronID i);
@@ -243,6 +365,9 @@ public:
 	NeuronID ** get_rowptrs();
 	T * get_data_begin(const StateID z=0);
 	T * get_data_end(const StateID z=0);
+	/*! Returns the values of state z for reading. Unlike get_data_begin this 
+	 * does not expand a uniform matrix and returns NULL instead (see compress_uniform). */
+	const T * get_const_data_begin(const StateID z=0);
 	/*! Returns the data value to an item that is i-th in the colindex array */
 	T get_value(NeuronID i);
 	/*! Returns the data value to an item that for pointer r pointing to the respective element in the index array */
@@ -257,18 +382,21 @@ public:
 template <typename T>
 T * ComplexMatrix<T>::get_data_ptr(AurynLong i, StateID z)
 {
+	expose_data();
 	return elementdata+z*get_datasize()+i;
 }
 
 template <typename T>
 T ComplexMatrix<T>::get_data(AurynLong i, StateID z)
 {
+	if ( elementdata == NULL ) return uniform_value;
 	return elementdata[z*get_datasize()+i];
 }
 
 template <typename T>
 T * ComplexMatrix<T>::get_data_ptr(const NeuronID * ind_ptr, StateID z) 
 {
+	expose_data();
 	size_t ptr_offset = ind_ptr-get_ind_begin();
 	return elementdata+ptr_offset;
 }
@@ -276,7 +404,8 @@ T * ComplexMatrix<T>::get_data_ptr(const NeuronID * ind_ptr, StateID z)
 template <typename T>
 T ComplexMatrix<T>::get_data(const NeuronID * ind_ptr, StateID z) 
 {
-	return *(get_data_ptr(ind_ptr));
+	if ( elementdata == NULL ) return uniform_value;
+	return elementdata[ind_ptr-get_ind_begin()];
 }
 
 
@@ -284,6 +413,8 @@ T ComplexMatrix<T>::get_data(const NeuronID * ind_ptr, StateID z)
 template <typename T>
 void ComplexMatrix<T>::set_data(AurynLong i, T value)
 {
+	if ( elementdata == NULL && value == uniform_value ) return;
+	expand_uniform();
 	if (i<statesize)
 		elementdata[i] = value;
 }
@@ -292,6 +423,8 @@ void ComplexMatrix<T>::set_data(AurynLong i, T value)
 template <typename T>
 void ComplexMatrix<T>::scale_data(AurynLong i, T value)
 {
+	if ( elementdata == NULL && value == 1 ) return;
+	expand_uniform();
 	if (i<statesize)
 		elementdata[i] *= value;
 }
@@ -305,6 +438,8 @@ void ComplexMatrix<T>::clear()
 	n_nonzero = 0;
 	rowptrs[0] = colinds;
 	rowptrs[1] = colinds;
+	col_index_valid = false;
+	local_index_valid = false;
 }
 
 template <typename T>
@@ -319,12 +454,20 @@ void ComplexMatrix<T>::init(NeuronID m, NeuronID n, AurynLong size, NeuronID z)
 	rowptrs = new NeuronID * [m_rows+1];
 	colinds = new NeuronID [get_datasize()];
 	elementdata = new T [get_memsize()];
+	uniform_value = 0;
+	data_exposed = false;
+	col_index = NULL;
+	local_colinds = NULL;
+	local_index_divisor = 0;
 	clear();
 }
 
 template <typename T>
 void ComplexMatrix<T>::resize_buffer(AurynLong size)
 {
+	if ( size < get_nonzero() ) throw AurynMatrixBufferException();
+
+	const AurynLong oldsize = statesize;
 	statesize = size;
 
 	NeuronID * new_colinds = new NeuronID [get_datasize()];
@@ -339,8 +482,14 @@ void ComplexMatrix<T>::resize_buffer(AurynLong size)
 	delete [] colinds;
 	colinds = new_colinds;
 
+	if ( elementdata == NULL ) return; // uniform matrix
+
+	// each state occupies a slice of length statesize, which has changed
 	T * new_elementdata = new T [get_memsize()];
-	std::copy(elementdata, elementdata+get_datasize(), new_elementdata);
+	for ( StateID z = 0 ; z < z_values ; ++z ) {
+		std::copy(elementdata+z*oldsize, elementdata+z*oldsize+get_nonzero(), 
+				new_elementdata+z*statesize);
+	}
 	delete [] elementdata;
 	elementdata = new_elementdata;
 }
@@ -384,6 +533,8 @@ void ComplexMatrix<T>::free()
 	delete [] rowptrs;
 	delete [] colinds;
 	delete [] elementdata;
+	delete col_index;
+	delete [] local_colinds;
 }
 
 template <typename T>
@@ -421,10 +572,14 @@ void ComplexMatrix<T>::push_back(NeuronID i, NeuronID j, T value)
 	if (i >= current_row && j >= current_col) {
 		if ( n_nonzero >= get_datasize() ) throw AurynMatrixBufferException();
 		*(rowptrs[i+1]) = j; // write last j to end of index array
-		elementdata[rowptrs[i+1]-colinds] = value; // write value to end of data array
+		if ( elementdata == NULL && value != uniform_value ) expand_uniform();
+		if ( elementdata != NULL ) 
+			elementdata[rowptrs[i+1]-colinds] = value; // write value to end of data array
 		++rowptrs[i+1]; //increment end by one
 		rowptrs[m_rows] = rowptrs[i+1]; // last (m_row+1) marks end of last row
 		n_nonzero++;
+		col_index_valid = false;
+		local_index_valid = false;
 	} else {
 		throw AurynMatrixPushBackException();
 	}
@@ -465,17 +620,142 @@ void ComplexMatrix<T>::fill_zeros()
 	current_row = get_m_rows();
 }
 
+template <typename T>
+bool ComplexMatrix<T>::compress_uniform()
+{
+	if ( is_uniform() ) return true;
+	if ( data_exposed || z_values != 1 || get_nonzero() == 0 ) return false;
+
+	const T value = elementdata[0];
+	for ( AurynLong i = 1 ; i < get_nonzero() ; ++i ) 
+		if ( elementdata[i] != value ) return false;
+
+	delete [] elementdata;
+	elementdata = NULL;
+	uniform_value = value;
+	return true;
+}
+
+template <typename T>
+void ComplexMatrix<T>::expand_uniform()
+{
+	if ( !is_uniform() ) return;
+	elementdata = new T [get_memsize()];
+	std::fill(elementdata, elementdata+get_memsize(), uniform_value);
+}
+
+template <typename T>
+bool ComplexMatrix<T>::is_uniform()
+{
+	return elementdata == NULL;
+}
+
+template <typename T>
+T ComplexMatrix<T>::get_uniform_value()
+{
+	return uniform_value;
+}
+
+template <typename T>
+void ComplexMatrix<T>::set_row_sizes(const AurynLong * sizes)
+{
+	AurynLong total = 0;
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) 
+		total += sizes[i];
+	if ( total > get_datasize() ) throw AurynMatrixBufferException();
+
+	rowptrs[0] = colinds;
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) 
+		rowptrs[i+1] = rowptrs[i]+sizes[i];
+	n_nonzero = total;
+	current_row = get_m_rows();
+	current_col = 0;
+	col_index_valid = false;
+	local_index_valid = false;
+}
+
+template <typename T>
+void ComplexMatrix<T>::append_row_sizes(NeuronID lo, NeuronID hi, const AurynLong * sizes)
+{
+	if ( hi <= lo ) return;
+	if ( hi > m_rows ) throw AurynMatrixDimensionalityException();
+	if ( lo < current_row || ( lo == current_row && rowptrs[lo+1] != rowptrs[lo] ) ) 
+		throw AurynMatrixPushBackException();
+
+	AurynLong total = 0;
+	for ( NeuronID i = lo ; i < hi ; ++i ) 
+		total += sizes[i-lo];
+	if ( n_nonzero + total > get_datasize() ) throw AurynMatrixBufferException();
+
+	// close the empty rows in between
+	for ( NeuronID i = current_row+1 ; i < lo ; ++i ) 
+		rowptrs[i+1] = rowptrs[i];
+	for ( NeuronID i = lo ; i < hi ; ++i ) 
+		rowptrs[i+1] = rowptrs[i]+sizes[i-lo];
+	rowptrs[m_rows] = rowptrs[hi];
+	n_nonzero += total;
+	current_row = hi-1;
+	current_col = 0;
+	col_index_valid = false;
+	local_index_valid = false;
+}
+
+
+template <typename T>
+void ComplexMatrix<T>::permute(const vector<NeuronID> * row_ids, const vector<NeuronID> * col_ids)
+{
+	if ( m_rows == 0 ) return;
+	const AurynLong nnz = get_nonzero();
+
+	// lay out the new rows
+	std::vector<AurynLong> sizes(m_rows);
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) {
+		const NeuronID r = row_ids ? (*row_ids)[i] : i;
+		sizes[r] = rowptrs[i+1]-rowptrs[i];
+	}
+	std::vector<AurynLong> begin(m_rows+1,0);
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) 
+		begin[i+1] = begin[i]+sizes[i];
+
+	// new column and old data index of each element in the new order
+	std::vector< std::pair<NeuronID,AurynLong> > elements(nnz);
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) {
+		const NeuronID r = row_ids ? (*row_ids)[i] : i;
+		AurynLong k = begin[r];
+		for ( NeuronID * c = rowptrs[i] ; c != rowptrs[i+1] ; ++c ) 
+			elements[k++] = std::make_pair( col_ids ? (*col_ids)[*c] : *c, (AurynLong)(c-colinds) );
+		if ( col_ids ) 
+			std::sort(elements.begin()+begin[r], elements.begin()+begin[r+1]);
+	}
+
+	for ( AurynLong k = 0 ; k < nnz ; ++k ) 
+		colinds[k] = elements[k].first;
+
+	if ( elementdata != NULL ) {
+		std::vector<T> tmp(nnz);
+		for ( StateID z = 0 ; z < z_values ; ++z ) {
+			T * data = elementdata+z*statesize;
+			for ( AurynLong k = 0 ; k < nnz ; ++k ) 
+				tmp[k] = data[elements[k].second];
+			std::copy(tmp.begin(), tmp.end(), data);
+		}
+	}
+
+	set_row_sizes(&sizes[0]);
+}
 
 template <typename T>
 T ComplexMatrix<T>::get(NeuronID i, NeuronID j, NeuronID z)
 {
-	return *get_ptr(i,j,z);
+	NeuronID * c = find_element(i,j);
+	if ( c == NULL ) return 0;
+	return get_data(c-colinds,z);
 }
 
 template <typename T>
 bool ComplexMatrix<T>::exists(NeuronID i, NeuronID j)
 {
-	if ( get_ptr(i,j) == NULL )
+	if ( find_element(i,j) == NULL )
 		return false;
 	else 
 		return true;
@@ -484,6 +764,7 @@ bool ComplexMatrix<T>::exists(NeuronID i, NeuronID j)
 template <typename T>
 void ComplexMatrix<T>::set_num_synapse_states(StateID zsize)
 {
+	expand_uniform();
 	z_values = zsize;
 	resize_buffer(statesize);
 }
@@ -508,6 +789,15 @@ T * ComplexMatrix<T>::get_ptr(NeuronID i, NeuronID j, NeuronID z)
 
 template <typename T>
 T * ComplexMatrix<T>::get_ptr(NeuronID i, NeuronID j)
+{
+	NeuronID * c = find_element(i,j);
+	if ( c == NULL ) return NULL;
+	expose_data();
+	return elementdata+(c-colinds);
+}
+
+template <typename T>
+NeuronID * ComplexMatrix<T>::find_element(NeuronID i, NeuronID j)
 {
 	// check bounds
 	if ( !(i < m_rows && j < n_cols) ) return NULL;
@@ -524,8 +814,8 @@ T * ComplexMatrix<T>::get_ptr(NeuronID i, NeuronID j)
 		//cout << i << ":" << j << "   " << *lo << ":" << *hi << endl;
 	}
 	
-	if ( *lo == j ) {
-		return elementdata+(lo-colinds);
+	if ( lo < rowptrs[i+1] && *lo == j ) {
+		return lo;
 	}
 
 	return NULL; 
@@ -534,18 +824,22 @@ T * ComplexMatrix<T>::get_ptr(NeuronID i, NeuronID j)
 template <typename T>
 T * ComplexMatrix<T>::get_ptr(AurynLong data_index)
 {
+	expose_data();
 	return &elementdata[data_index];
 }
 
 template <typename T>
 T ComplexMatrix<T>::get_value(AurynLong data_index)
 {
+	if ( elementdata == NULL ) return uniform_value;
 	return elementdata[data_index];
 }
 
 template <typename T>
 void ComplexMatrix<T>::add_value(AurynLong data_index, T value)
 {
+	if ( elementdata == NULL && value == 0 ) return;
+	expand_uniform();
 	elementdata[data_index] += value;
 }
 
@@ -555,12 +849,19 @@ NeuronID ComplexMatrix<T>::get_colind(AurynLong data_index)
 	return colinds[data_index];
 }
 
+template <typename T>
+NeuronID ComplexMatrix<T>::get_rowind(AurynLong data_index)
+{
+	// empty rows share their row pointer with the next row
+	return std::upper_bound(rowptrs, rowptrs+m_rows+1, colinds+data_index)-rowptrs-1;
+}
+
 template <typename T>
 bool ComplexMatrix<T>::set(NeuronID i, NeuronID j, T value)
 {
-	T * ptr = get_ptr(i,j);
-	if ( ptr != NULL) {
-		*ptr = value;
+	NeuronID * c = find_element(i,j);
+	if ( c != NULL) {
+		set_data(c-colinds, value);
 		return true;
 	}
 	else
@@ -570,10 +871,13 @@ bool ComplexMatrix<T>::set(NeuronID i, NeuronID j, T value)
 template <typename T>
 void ComplexMatrix<T>::scale_row(NeuronID i, T value)
 {
+	if ( elementdata == NULL && value == 1 ) return;
+	expand_uniform();
+
 	NeuronID * rowbegin = rowptrs[i];
-	NeuronID * rowend = rowptrs[i+1]--;
+	NeuronID * rowend = rowptrs[i+1];
 
-	for (NeuronID * c = rowbegin ; c <= rowend ; ++c) 
+	for (NeuronID * c = rowbegin ; c < rowend ; ++c) 
 	{
 		elementdata[c-colinds] *= value;
 	}
@@ -582,6 +886,10 @@ void ComplexMatrix<T>::scale_row(NeuronID i, T value)
 template <typename T>
 void ComplexMatrix<T>::scale_all(T value)
 {
+	if ( elementdata == NULL ) {
+		uniform_value *= value;
+		return;
+	}
 	for ( AurynLong i = 0 ; i < n_nonzero ; ++i ) 
 		scale_data( i , value );
 }
@@ -589,10 +897,13 @@ void ComplexMatrix<T>::scale_all(T value)
 template <typename T>
 void ComplexMatrix<T>::set_row(NeuronID i, T value)
 {
+	if ( elementdata == NULL && value == uniform_value ) return;
+	expand_uniform();
+
 	NeuronID * rowbegin = rowptrs[i];
-	NeuronID * rowend = rowptrs[i+1]--;
+	NeuronID * rowend = rowptrs[i+1];
 
-	for (NeuronID * c = rowbegin ; c <= rowend ; ++c) 
+	for (NeuronID * c = rowbegin ; c < rowend ; ++c) 
 	{
 		elementdata[c-colinds] = value;
 	}
@@ -601,15 +912,90 @@ void ComplexMatrix<T>::set_row(NeuronID i, T value)
 template <typename T>
 void ComplexMatrix<T>::set_all(T value)
 {
+	if ( elementdata == NULL ) {
+		uniform_value = value;
+		return;
+	}
 	for ( AurynLong i = 0 ; i < n_nonzero ; ++i ) 
 		set_data( i , value );
 }
 
+template <typename T>
+void ComplexMatrix<T>::build_col_index()
+{
+	// offsets into the data array are stored as 32bit integers
+	if ( get_datasize() > std::numeric_limits<AurynInt>::max() ) 
+		throw AurynMatrixBufferException();
+
+	AurynLong bufsize = std::max(get_nonzero(),(AurynLong)1);
+	if ( col_index == NULL ) {
+		col_index = new SimpleMatrix<AurynInt>(get_n_cols(), get_m_rows(), bufsize);
+	} else if ( col_index->get_datasize() < get_nonzero() ) {
+		col_index->resize_buffer_and_clear(bufsize);
+	} else {
+		col_index->clear();
+	}
+
+	// count elements per column
+	std::vector<AurynLong> sizes(get_n_cols(),0);
+	for ( AurynLong i = 0 ; i < get_nonzero() ; ++i ) 
+		sizes[colinds[i]]++;
+	col_index->set_row_sizes(&sizes[0]);
+
+	// scatter row indices and data offsets -- since rows are traversed 
+	// in ascending order each column ends up sorted by row
+	std::vector<AurynLong> next(get_n_cols());
+	for ( NeuronID j = 0 ; j < get_n_cols() ; ++j ) 
+		next[j] = col_index->get_row_begin_index(j);
+
+	NeuronID * ind = col_index->get_ind_begin();
+	AurynInt * offsets = col_index->get_data_begin();
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		for ( NeuronID * r = get_row_begin(i) ; r != get_row_end(i) ; ++r ) {
+			AurynLong k = next[*r]++;
+			ind[k] = i;
+			offsets[k] = r-colinds;
+		}
+	}
+
+	col_index_valid = true;
+}
+
+template <typename T>
+SimpleMatrix<AurynInt> * ComplexMatrix<T>::get_col_index()
+{
+	if ( !col_index_valid ) build_col_index();
+	return col_index;
+}
+
+template <typename T>
+unsigned short * ComplexMatrix<T>::get_local_index(NeuronID divisor)
+{
+	if ( local_index_valid && divisor == local_index_divisor ) 
+		return local_colinds;
+
+	delete [] local_colinds;
+	local_colinds = NULL;
+	local_index_divisor = divisor;
+	local_index_valid = true; // also remembers when the indices do not fit
+
+	const NeuronID limit = std::numeric_limits<unsigned short>::max();
+	for ( AurynLong i = 0 ; i < get_nonzero() ; ++i ) 
+		if ( colinds[i]/divisor > limit ) return NULL;
+
+	local_colinds = new unsigned short [std::max(get_nonzero(),(AurynLong)1)];
+	for ( AurynLong i = 0 ; i < get_nonzero() ; ++i ) 
+		local_colinds[i] = colinds[i]/divisor;
+	return local_colinds;
+}
+
 template <typename T>
 void ComplexMatrix<T>::scale_col(NeuronID j, T value)
 {
-	for ( AurynLong i = 0 ; i < n_nonzero ; ++i ) {
-		if ( colinds[i] == j ) scale_data(i,value);
+	expand_uniform();
+	SimpleMatrix<AurynInt> * idx = get_col_index();
+	for ( NeuronID * c = idx->get_row_begin(j) ; c != idx->get_row_end(j) ; ++c ) {
+		elementdata[idx->get_data(c)] *= value;
 	}
 }
 
@@ -617,9 +1003,11 @@ template <typename T>
 double ComplexMatrix<T>::sum_col(NeuronID j)
 {
 	double sum = 0;
-	for ( AurynLong i = 0 ; i < n_nonzero ; ++i ) {
-		if ( colinds[i] == j ) 
-			sum += *(get_data_begin()+i);
+	SimpleMatrix<AurynInt> * idx = get_col_index();
+	if ( elementdata == NULL ) 
+		return uniform_value*(double)(idx->get_row_end(j)-idx->get_row_begin(j));
+	for ( NeuronID * c = idx->get_row_begin(j) ; c != idx->get_row_end(j) ; ++c ) {
+		sum += elementdata[idx->get_data(c)];
 	}
 	return sum;
 }
@@ -627,9 +1015,54 @@ double ComplexMatrix<T>::sum_col(NeuronID j)
 template <typename T>
 void ComplexMatrix<T>::set_col(NeuronID j, T value)
 {
-	for ( AurynLong i = 0 ; i < n_nonzero ; ++i ) {
-		if ( colinds[i] == j ) set_data(i,value);
+	if ( elementdata == NULL && value == uniform_value ) return;
+	expand_uniform();
+	SimpleMatrix<AurynInt> * idx = get_col_index();
+	for ( NeuronID * c = idx->get_row_begin(j) ; c != idx->get_row_end(j) ; ++c ) {
+		elementdata[idx->get_data(c)] = value;
+	}
+}
+
+template <typename T>
+void ComplexMatrix<T>::normalize_col(NeuronID j, T target)
+{
+	double sum = sum_col(j);
+	if ( sum != 0 ) 
+		scale_col(j, target/sum);
+}
+
+template <typename T>
+void ComplexMatrix<T>::clip_col(NeuronID j, T lo, T hi)
+{
+	expand_uniform();
+	SimpleMatrix<AurynInt> * idx = get_col_index();
+	for ( NeuronID * c = idx->get_row_begin(j) ; c != idx->get_row_end(j) ; ++c ) {
+		T * ptr = elementdata+idx->get_data(c);
+		if ( *ptr < lo ) 
+			*ptr = lo;
+		else if ( *ptr > hi ) 
+			*ptr = hi;
+	}
+}
+
+template <typename T>
+void ComplexMatrix<T>::normalize_cols(T target)
+{
+	expand_uniform();
+	std::vector<double> sums(get_n_cols(),0.0);
+	for ( AurynLong i = 0 ; i < get_nonzero() ; ++i ) 
+		sums[colinds[i]] += elementdata[i];
+
+	std::vector<T> factors(get_n_cols());
+	for ( NeuronID j = 0 ; j < get_n_cols() ; ++j ) {
+		if ( sums[j] != 0 ) 
+			factors[j] = target/sums[j];
+		else 
+			factors[j] = 1;
 	}
+
+	for ( AurynLong i = 0 ; i < get_nonzero() ; ++i ) 
+		elementdata[i] *= factors[colinds[i]];
 }
 
 template <typename T>
@@ -644,6 +1077,19 @@ NeuronID * ComplexMatrix<T>::get_row_begin(NeuronID i)
 	return rowptrs[i];
 }
 
+template <typename T>
+void ComplexMatrix<T>::prefetch_row(NeuronID i, StateID z)
+{
+#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
+	const AurynLong k = rowptrs[i]-colinds;
+	_mm_prefetch((const char *)(colinds+k), _MM_HINT_T0);
+	if ( elementdata != NULL ) 
+		_mm_prefetch((const char *)(elementdata+z*statesize+k), _MM_HINT_T0);
+	if ( local_colinds != NULL && local_index_valid ) 
+		_mm_prefetch((const char *)(local_colinds+k), _MM_HINT_T0);
+#endif
+}
+
 template <typename T>
 AurynLong ComplexMatrix<T>::get_row_begin_index(NeuronID i)
 {
@@ -681,6 +1127,13 @@ T * ComplexMatrix<T>::get_data_end(StateID z)
 	return get_data_ptr(get_nonzero(),z);
 }
 
+template <typename T>
+const T * ComplexMatrix<T>::get_const_data_begin(StateID z)
+{
+	if ( elementdata == NULL ) return NULL;
+	return elementdata+z*statesize;
+}
+
 
 template <typename T>
 AurynDouble ComplexMatrix<T>::get_fill_level()
@@ -711,7 +1164,7 @@ void ComplexMatrix<T>::print()
 {
 	for (NeuronID i = 0 ; i < m_rows ; ++i) {
 		for (NeuronID * r = get_row_begin(i) ; r != get_row_end(i) ; ++r ) {
-			cout << i << " " << *r << " " << elementdata[r-colinds] << "\n"; 
+			cout << i << " " << *r << " " << get_value(r) << "\n"; 
 			// FIXME not dumping the other states yet
 		}
 	}
@@ -721,6 +1174,7 @@ template <typename T>
 double ComplexMatrix<T>::mean()
 {
 	double sum = 0;
+	if ( elementdata == NULL ) return uniform_value;
 	for (NeuronID i = 0 ; i < get_nonzero() ; ++i) {
 		sum += elementdata[i];
 	}
@@ -794,13 +1248,15 @@ void ComplexMatrix<T>::state_add_const(T a, AurynWeight * y)
 template <typename T>
 T ComplexMatrix<T>::get_value(NeuronID i)
 {
-	return get_data_begin()[i];
+	if ( elementdata == NULL ) return uniform_value;
+	return elementdata[i];
 }
 
 template <typename T>
 T ComplexMatrix<T>::get_value(NeuronID * r)
 {
-	return get_data_begin()[r-get_ind_begin()];
+	if ( elementdata == NULL ) return uniform_value;
+	return elementdata[r-get_ind_begin()];
 }
 
 template <typename T>
@@ -152,3 +152,25 @@ void Connection::evolve()
 {
 
 }
+
+void Connection::apply_pending_updates() 
+{
+
+}
+
+bool Connection::allows_temporal_blocking() 
+{
+	return false;
+}
+
+bool Connection::allows_neuron_permutation() 
+{
+	return false;
+}
+
+void Connection::permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids)
+{
+	stringstream oss;
+	oss << "Connection: ("<< get_name() <<"): Does not support renumbering of neurons.";
+	logger->msg(oss.str(),ERROR);
+}
@@ -107,6 +107,23 @@ public:
 	virtual void propagate() = 0;
 	virtual void evolve();
 
+	/*! Returns true if propagate() only depends on the delayed spikes of the 
+	 * source, only changes the state of the destination and evolve() does 
+	 * nothing. Such Connections can be propagated together with their 
+	 * destination for several time steps in a row (see System::set_temporal_blocking).
+	 * Defaults to false. */
+	virtual bool allows_temporal_blocking();
+
+	/*! Returns true if the neurons of source and destination can be 
+	 * renumbered with permute_neurons (see System::reorder_neurons). 
+	 * Defaults to false. */
+	virtual bool allows_neuron_permutation();
+
+	/*! Renumbers the neurons of source and destination such that synapses 
+	 * from neuron i are moved to pre_ids[i] and synapses onto neuron j 
+	 * to post_ids[j]. A NULL pointer leaves the respective side unchanged. */
+	virtual void permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids);
+
 	/*! DEPRECATED. (Such connections should not be registered in the first place) Calls propagate only if the postsynaptic NeuronGroup exists on the local rank. */
 	void conditional_propagate();
 
@@ -128,8 +145,16 @@ public:
 	/*! Same as transmit but checks if the target neuron exists */
 	void safe_transmit(NeuronID id, AurynWeight amount);
 
+	/*! Hints the CPU to load the transmitter state of the neuron with the 
+	 * rank local id localid into cache. */
+	inline void prefetch_target(NeuronID localid);
+
+	/*! Applies weight updates which the connection has deferred. Called 
+	 * before the weights are read or modified from outside of propagate. */
+	virtual void apply_pending_updates();
+
 	/*! Returns a vector of ConnectionsID of a block specified by the arguments */
-	virtual vector<neuron_pair>  get_block(NeuronID lo_row, NeuronID lo_col, NeuronID hi_row,  NeuronID hi_col) = 0;
+	virtual vector<neuron_pair>  get_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_col, NeuronID hi_col) = 0;
 
 };
 
@@ -141,4 +166,11 @@ inline void Connection::transmit(NeuronID id, AurynWeight amount)
 	target[localid]+=amount;
 }
 
+inline void Connection::prefetch_target(NeuronID localid) 
+{
+#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
+	_mm_prefetch((const char *)(target+localid), _MM_HINT_T0);
+#endif
+}
+
 #endif /*CONNECTION_H_*/
@@ -0,0 +1,102 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#ifndef COUNTERRANDOMSTREAM_H_
+#define COUNTERRANDOMSTREAM_H_
+
+#include "auryn_definitions.h"
+
+using namespace std;
+
+/*! \brief Counter-based random number stream
+ *
+ * The n-th number of a stream is computed by hashing the stream key and n 
+ * (SplitMix64 finalizer). Creating a stream is therefore free, any position 
+ * of a stream can be reached without generating the numbers before it, and 
+ * the streams for different stream ids of the same seed are independent. 
+ * This allows to generate random connectivity in parallel with results that
+ * do not depend on how the work is split among threads.
+ */
+class CounterRandomStream
+{
+private:
+	AurynLong key;
+	AurynLong counter;
+
+public:
+	/*! Returns a well mixed 64 bit value for x (SplitMix64 finalizer). */
+	static inline AurynLong mix(AurynLong x)
+	{
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9UL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebUL;
+		return x ^ (x >> 31);
+	}
+
+	/*! Sets up the stream with the given id for a seed. */
+	CounterRandomStream(AurynLong seed, AurynLong stream)
+	{
+		set_stream(seed, stream);
+	}
+
+	/*! Switches to the beginning of the stream with the given id for a seed. */
+	inline void set_stream(AurynLong seed, AurynLong stream)
+	{
+		key = mix( mix(seed) + stream );
+		counter = 0;
+	}
+
+	/*! Moves to position n of the current stream. */
+	inline void set_position(AurynLong n)
+	{
+		counter = n;
+	}
+
+	/*! Returns the next 64 bit random number. */
+	inline AurynLong next()
+	{
+		return mix( key + 0x9e3779b97f4a7c15UL * (++counter) );
+	}
+
+	/*! Returns the next random number uniformly distributed in [0,1). */
+	inline AurynDouble uniform()
+	{
+		return (next() >> 11) * (1.0/9007199254740992.0);
+	}
+
+	/*! Returns the number of failures before the first success in a 
+	 * sequence of Bernoulli trials with success probability p, i.e. the 
+	 * distance to the next element when drawing elements independently with 
+	 * probability p.
+	 * \param log_q The precomputed value of log(1-p) for 0<p<1
+	 * \param max Value returned when the draw exceeds max */
+	inline AurynLong geometric(AurynDouble log_q, AurynLong max)
+	{
+		const AurynDouble x = std::log(1.0-uniform())/log_q;
+		if ( x < max ) return (AurynLong) x;
+		return max;
+	}
+};
+
+#endif /*COUNTERRANDOMSTREAM_H_*/
@@ -80,22 +80,26 @@ void CubaIFGroup::evolve()
 {
 
 
-	for (NeuronID i = 0 ; i < get_rank_size() ; ++i ) {
-    	if (t_ref[i]==0) {
+	unsigned char spike_flags[FUSED_KERNEL_BLOCK_SIZE];
+
+	for ( NeuronID begin = 0 ; begin < get_rank_size() ; begin += FUSED_KERNEL_BLOCK_SIZE ) {
+		const NeuronID end = std::min(begin+FUSED_KERNEL_BLOCK_SIZE, get_rank_size());
+
+		// branch free integration, threshold check, reset and refractoriness
+#pragma GCC ivdep // the state vectors never overlap
+		for (NeuronID i = begin ; i < end ; ++i ) {
+			const bool active = t_ref[i]==0;
 			const AurynFloat dg_mem = ( (e_rest-t_mem[i]) 
 					+ t_bg_cur[i] );
-			t_mem[i] += dg_mem*scale_mem;
-
-			if (t_mem[i]>thr) {
-				push_spike(i);
-				t_mem[i] = e_rest ;
-				t_ref[i] += refractory_time ;
-			} 
-		} else {
-			t_ref[i]-- ;
-			t_mem[i] = e_rest ;
+			const AurynFloat v = t_mem[i] + dg_mem*scale_mem;
+			const bool spike = active & ( v>thr );
+
+			spike_flags[i-begin] = spike;
+			t_mem[i] = ( active && !spike ) ? v : e_rest;
+			t_ref[i] = active ? ( spike ? refractory_time : 0 ) : t_ref[i]-1;
 		}
 
+		push_spikes(spike_flags, begin, end);
 	}
 
 }
@@ -73,9 +73,10 @@ void DelayedSpikeMonitor::set_offset(NeuronID of)
 void DelayedSpikeMonitor::propagate()
 {
 	for (it = src->get_spikes()->begin() ; it != src->get_spikes()->end() ; ++it ) {
-		if (*it >= n_from ) {
-			if ( *it < n_to ) 
-			 outfile << dt*(sys->get_clock()) << "  " << *it+offset << "\n";
+		const NeuronID id = src->get_original_id(*it);
+		if (id >= n_from ) {
+			if ( id < n_to ) 
+			 outfile << dt*(sys->get_clock()) << "  " << id+offset << "\n";
 		}
 	}
 }
@@ -25,12 +25,22 @@
 
 #include "DuplexConnection.h"
 
+void DuplexConnection::init_lazy_updates() 
+{
+	lazy_updates = false;
+	lazy_pending = false;
+	lazy_pre_trace = NULL;
+	lazy_trace_decay = 1.0;
+	lazy_history_size = DEFAULT_LAZY_HISTORY_SIZE;
+}
+
 void DuplexConnection::init() 
 {
 	fwd = w; // for consistency declared here. fwd can be overwritten later though
 	bkw = new BackwardMatrix ( get_n_cols(), get_m_rows(), w->get_nonzero() );
 	allocated_bkw=true;
 	compute_reverse_matrix();
+	if ( lazy_updates ) reset_lazy_state();
 }
 
 void DuplexConnection::finalize() // finalize at this level is called only for reconnecting or non-Constructor building of the matrix
@@ -51,6 +61,7 @@ DuplexConnection::DuplexConnection(const char * filename)
 : SparseConnection(filename)
 {
 	allocated_bkw=false;
+	init_lazy_updates();
 	if ( dst->get_post_size() > 0 ) 
 		init();
 }
@@ -60,6 +71,7 @@ DuplexConnection::DuplexConnection(SpikingGroup * source, NeuronGroup * destinat
 : SparseConnection(source, destination, transmitter)
 {
 	allocated_bkw=false;
+	init_lazy_updates();
 }
 
 DuplexConnection::DuplexConnection(SpikingGroup * source, NeuronGroup * destination, 
@@ -68,6 +80,7 @@ DuplexConnection::DuplexConnection(SpikingGroup * source, NeuronGroup * destinat
 : SparseConnection(source, destination, filename, transmitter)
 {
 	allocated_bkw=false;
+	init_lazy_updates();
 	if ( dst->get_post_size() > 0 ) 
 		init();
 }
@@ -77,6 +90,7 @@ DuplexConnection::DuplexConnection(NeuronID rows, NeuronID cols)
 : SparseConnection(rows,cols)
 {
 	allocated_bkw=false;
+	init_lazy_updates();
 	init();
 }
 
@@ -85,6 +99,8 @@ DuplexConnection::DuplexConnection( SpikingGroup * source, NeuronGroup * destina
 		TransmitterType transmitter, string name) 
 : SparseConnection(source,destination,weight,sparseness,transmitter, name)
 {
+	allocated_bkw=false;
+	init_lazy_updates();
 	if ( dst->get_post_size() > 0 ) 
 		init();
 }
@@ -94,6 +110,18 @@ void DuplexConnection::free()
 	delete bkw;
 }
 
+bool DuplexConnection::allows_temporal_blocking()
+{
+	return false;
+}
+
+void DuplexConnection::permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids)
+{
+	apply_pending_updates();
+	SparseConnection::permute_neurons(pre_ids, post_ids);
+	DuplexConnection::finalize();
+}
+
 
 DuplexConnection::~DuplexConnection()
 {
@@ -105,6 +133,14 @@ DuplexConnection::~DuplexConnection()
 void DuplexConnection::compute_reverse_matrix()
 {
 
+	if ( fwd->get_datasize() > std::numeric_limits<AurynInt>::max() ) {
+		stringstream oss;
+		oss << "DuplexConnection: ("<< get_name() << "): Forward matrix too large "
+			"to be indexed by 32-bit offsets.";
+		logger->msg(oss.str(),ERROR);
+		throw AurynMatrixBufferException();
+	}
+
 	if ( fwd->get_nonzero() <= bkw->get_datasize() ) {
 		bkw->clear();
 	} else {
@@ -116,27 +152,66 @@ void DuplexConnection::compute_reverse_matrix()
 	oss << "DuplexConnection: ("<< get_name() << "): Computing backward matrix ...";
 	logger->msg(oss.str(),NOTIFICATION);
 
-	NeuronID maxrows = get_m_rows();
-	NeuronID maxcols = get_n_cols();
-	NeuronID ** rowwalker = new NeuronID * [maxrows+1];
-	// copy pointer arrays
-	for ( NeuronID i = 0 ; i < maxrows+1 ; ++i ) {
-		rowwalker[i] = (fwd->get_rowptrs())[i];
+	// The transpose is computed by counting sort in O(nnz). The rows of the 
+	// forward matrix are split into contiguous chunks (one per thread). Each
+	// chunk counts its elements per column, which determines where it writes 
+	// into each row of the backward matrix such that the rows stay ordered.
+	const NeuronID maxrows = get_m_rows();
+	const NeuronID maxcols = get_n_cols();
+	NeuronID ** fwd_rowptrs = fwd->get_rowptrs();
+
+	int nchunks = 1;
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	nchunks = std::max(1,std::min(sys->get_num_threads(),(int)maxrows));
+#endif /* CODE_ACTIVATE_OPENMP_THREADS */
+
+	vector<char> local_col(maxcols);
+	for ( NeuronID j = 0 ; j < maxcols ; ++j ) 
+		local_col[j] = dst->localrank(j);
+
+	// count elements per chunk and column
+	vector<AurynLong> offsets((AurynLong)nchunks*maxcols,0);
+	#pragma omp parallel for num_threads(nchunks) if(nchunks>1)
+	for ( int c = 0 ; c < nchunks ; ++c ) {
+		AurynLong * count = &offsets[(AurynLong)c*maxcols];
+		const NeuronID begin = (AurynLong)maxrows*c/nchunks;
+		const NeuronID end = (AurynLong)maxrows*(c+1)/nchunks;
+		for ( NeuronID * r = fwd_rowptrs[begin] ; r < fwd_rowptrs[end] ; ++r ) 
+			if ( local_col[*r] ) ++count[*r];
 	}
+
+	// turn counts into write positions and row sizes
+	vector<AurynLong> row_sizes(maxcols,0);
+	AurynLong pos = 0;
 	for ( NeuronID j = 0 ; j < maxcols ; ++j ) {
-		if ( dst->localrank(j) ) {
-			for ( NeuronID i = 0 ; i < maxrows ; ++i ) {
-				if (rowwalker[i] < fwd->get_rowptrs()[i+1]) { // stop when reached end of row
-					if (*rowwalker[i]==j) { // if there is an element for that column add pointer to backward matrix
-						bkw->push_back(j,i,fwd->get_ptr(i,j));
-						++rowwalker[i];  // move on when processed element
-					}
-				}
+		for ( int c = 0 ; c < nchunks ; ++c ) {
+			AurynLong & n = offsets[(AurynLong)c*maxcols+j];
+			row_sizes[j] += n;
+			const AurynLong tmp = n;
+			n = pos;
+			pos += tmp;
+		}
+	}
+	if ( maxcols ) bkw->set_row_sizes(&row_sizes[0]);
+
+	// scatter offsets of the forward weights 
+	NeuronID * fwd_ind = fwd->get_ind_begin();
+	NeuronID * bkw_ind = bkw->get_ind_begin();
+	AurynInt * bkw_data = bkw->get_data_begin();
+	#pragma omp parallel for num_threads(nchunks) if(nchunks>1)
+	for ( int c = 0 ; c < nchunks ; ++c ) {
+		AurynLong * next = &offsets[(AurynLong)c*maxcols];
+		const NeuronID begin = (AurynLong)maxrows*c/nchunks;
+		const NeuronID end = (AurynLong)maxrows*(c+1)/nchunks;
+		for ( NeuronID i = begin ; i < end ; ++i ) {
+			for ( NeuronID * r = fwd_rowptrs[i] ; r < fwd_rowptrs[i+1] ; ++r ) {
+				if ( !local_col[*r] ) continue;
+				const AurynLong k = next[*r]++;
+				bkw_ind[k] = i;
+				bkw_data[k] = r-fwd_ind;
 			}
 		}
 	}
-	bkw->fill_zeros();
-	delete [] rowwalker;
 
 	if ( fwd->get_nonzero() != bkw->get_nonzero() ) {
 		oss.str("");
@@ -153,3 +228,111 @@ void DuplexConnection::compute_reverse_matrix()
 	}
 }
 
+void DuplexConnection::add_to_bkw_row(NeuronID post, PRE_TRACE_MODEL * pre_trace, AurynFloat a, AurynFloat b)
+{
+	const NeuronID * begin = bkw->get_row_begin(post);
+	const NeuronID n = bkw->get_row_end(post)-begin;
+	const AurynInt * offsets = bkw->get_data_begin()+(begin-bkw->get_ind_begin());
+	AurynWeight * data = fwd->get_data_begin();
+	const AurynWeight wmax = get_max_weight();
+
+#ifndef PRE_TRACE_MODEL_LINTRACE
+	// the gathers take signed 32-bit offsets
+	if ( fwd->get_datasize() <= (AurynLong)std::numeric_limits<int>::max() ) {
+		auryn_indexed_saxpy_clip(a, b, pre_trace->get_state_ptr()->data, begin, data, offsets, wmax, n);
+		return;
+	}
+#endif /* PRE_TRACE_MODEL_LINTRACE */
+
+	for ( NeuronID k = 0 ; k < n ; ++k ) {
+		AurynWeight * weight = data+offsets[k];
+		*weight += (a*pre_trace->get(begin[k]))*b;
+		if ( *weight > wmax ) *weight = wmax;
+	}
+}
+
+void DuplexConnection::set_lazy_updates(bool lazy, unsigned int history_size)
+{
+	if ( dst->get_post_size() == 0 ) return;
+
+	if ( lazy && lazy_pre_trace == NULL ) {
+		stringstream oss;
+		oss << "DuplexConnection: ("<< get_name() << "): Does not support lazy updates.";
+		logger->msg(oss.str(),WARNING);
+		return;
+	}
+
+	apply_pending_updates();
+	lazy_updates = lazy;
+	lazy_history_size = std::max(history_size,1u);
+
+	if ( lazy_updates ) {
+		reset_lazy_state();
+	} else {
+		pending_post_spikes.clear();
+		lazy_row_time.clear();
+		lazy_trace_time.clear();
+		lazy_trace_value.clear();
+		lazy_trace_last.clear();
+	}
+}
+
+void DuplexConnection::reset_lazy_state()
+{
+	const AurynTime now = sys->get_clock();
+	const NeuronID rows = get_m_rows();
+
+	lazy_trace_decay = exp(-dt/lazy_pre_trace->get_tau());
+	lazy_decay_table.clear();
+	for ( AurynDouble x = 1.0 ; x > 1e-8 ; x *= lazy_trace_decay ) 
+		lazy_decay_table.push_back(x);
+	pending_post_spikes.assign(dst->get_post_size(), vector<PendingPostSpike>());
+	lazy_row_time.assign(rows, now);
+	lazy_trace_time.assign(rows, now);
+	lazy_trace_value.resize(rows);
+	lazy_trace_last.resize(rows);
+	for ( NeuronID i = 0 ; i < rows ; ++i ) {
+		lazy_trace_value[i] = lazy_pre_trace->get(i);
+		lazy_trace_last[i] = lazy_trace_value[i];
+	}
+	lazy_pending = false;
+}
+
+void DuplexConnection::update_pending_row(NeuronID pre)
+{
+	// the trace read in this time step does not contain the current spike yet
+	const AurynFloat trace = lazy_pre_trace->get(pre);
+	const AurynTime now = sys->get_clock();
+	lazy_row_time[pre] = now;
+	lazy_trace_last[pre] = trace;
+	lazy_trace_time[pre] = now+1;
+	lazy_trace_value[pre] = (trace+1)*lazy_trace_decay;
+}
+
+void DuplexConnection::add_pending_post_spike(NeuronID post, AurynFloat amplitude)
+{
+	PendingPostSpike spike;
+	spike.time = sys->get_clock();
+	spike.amplitude = amplitude;
+	pending_post_spikes[post].push_back(spike);
+	lazy_pending = true;
+
+	if ( pending_post_spikes[post].size() >= lazy_history_size ) 
+		apply_pending_updates();
+}
+
+void DuplexConnection::apply_pending_updates()
+{
+	if ( !lazy_updates || !lazy_pending ) return;
+
+	const AurynTime now = sys->get_clock();
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		for ( NeuronID * c = w->get_row_begin(i) ; c != w->get_row_end(i) ; ++c ) 
+			apply_pending_post_spikes(i, dst->global2rank(*c), w->get_data_ptr(c));
+		lazy_row_time[i] = now;
+	}
+
+	for ( NeuronID j = 0 ; j < pending_post_spikes.size() ; ++j ) 
+		pending_post_spikes[j].clear();
+	lazy_pending = false;
+}
@@ -38,8 +38,22 @@
 
 using namespace std;
 
-/*! Definition of BackwardMatrix - a sparsematrix of pointers to weight values. */
-typedef SimpleMatrix<AurynWeight*> BackwardMatrix;
+/*! Definition of BackwardMatrix - a sparsematrix of 32-bit offsets into the data array of the forward matrix. */
+typedef SimpleMatrix<AurynInt> BackwardMatrix;
+
+/*! Default number of pending postsynaptic spikes per neuron after which a 
+ * DuplexConnection with lazy updates applies all pending updates. */
+#define DEFAULT_LAZY_HISTORY_SIZE 64
+
+/*! \brief A postsynaptic spike whose weight updates have not been applied yet 
+ * (see DuplexConnection::set_lazy_updates). */
+struct PendingPostSpike 
+{
+	/*! Time step of the spike */
+	AurynTime time;
+	/*! Weight change per unit of the presynaptic trace */
+	AurynFloat amplitude;
+};
 
 /*! \brief Duplex connection is the base class of most plastic connections.
  * 
@@ -49,16 +63,81 @@ typedef SimpleMatrix<AurynWeight*> BackwardMatrix;
  * To do this efficiently, the weight matrix (ForwardMatrix) which allows for efficient 
  * forward propagation of spikes is mirrored as its transposed (BackwardMatrix). 
  * To keep the two matrices in sync the BackwardMatrix does not contain the actual weight
- * value to the forward weight, but a pointer reference to that value.
+ * value to the forward weight, but the offset of that value in the data array of the 
+ * ForwardMatrix (see get_bkw_weight_ptr). Storing 32-bit offsets instead of pointers halves the 
+ * memory footprint of the BackwardMatrix.
+ *
+ * Connections whose update upon a postsynaptic spike is the product of the 
+ * presynaptic trace and a postsynaptic factor can defer these updates (see 
+ * set_lazy_updates). A postsynaptic spike is then only recorded together with
+ * its factor and the affected weights are updated when they are read next, 
+ * i.e. when their row transmits a presynaptic spike or before the weights are 
+ * accessed through the Connection interface. The presynaptic trace at the 
+ * time of the postsynaptic spike is reconstructed from its value at the last 
+ * presynaptic spike, similar to LinearTrace.
  */
 class DuplexConnection : public SparseConnection
 {
 private:
 	bool allocated_bkw;
 	void init();
+	void init_lazy_updates();
 	void free();
 protected:
 	void compute_reverse_matrix();
+
+	/*! Returns a pointer to the forward weight referenced by the element c of the backward index array. */
+	AurynWeight * get_bkw_weight_ptr(const NeuronID * c)
+	{
+		return fwd->get_data_begin()+bkw->get_data(c);
+	}
+
+	/*! Adds (a*pre_trace(i))*b to the weights of all synapses from the presynaptic 
+	 * neurons i in the row of post (global id) of the backward matrix and clips them at 
+	 * the maximum weight. The updates are computed in SIMD chunks which gather 
+	 * the traces and weights (see auryn_indexed_saxpy_clip). */
+	void add_to_bkw_row(NeuronID post, PRE_TRACE_MODEL * pre_trace, AurynFloat a, AurynFloat b=1.0);
+
+	/*! Toggles whether updates upon postsynaptic spikes are deferred. */
+	bool lazy_updates;
+	/*! True if there are postsynaptic spikes which were not applied to all weights yet. */
+	bool lazy_pending;
+	/*! Presynaptic trace used by the update upon a postsynaptic spike. Connections 
+	 * which support lazy updates set it in their init. */
+	PRE_TRACE_MODEL * lazy_pre_trace;
+	/*! Decay factor of lazy_pre_trace per time step. */
+	AurynDouble lazy_trace_decay;
+	/*! Powers of lazy_trace_decay until they drop below 1e-8. Older traces 
+	 * count as zero since their contribution is below the float resolution 
+	 * of the weights. */
+	vector<AurynFloat> lazy_decay_table;
+	/*! Number of pending spikes per postsynaptic neuron after which all pending updates are applied. */
+	unsigned int lazy_history_size;
+	/*! Pending spikes of each postsynaptic neuron (rank local id). */
+	vector< vector<PendingPostSpike> > pending_post_spikes;
+	/*! Time from which on the pending spikes have not been applied to row i yet. */
+	vector<AurynTime> lazy_row_time;
+	/*! The presynaptic trace of row i has decayed freely from lazy_trace_value[i] since lazy_trace_time[i]. */
+	vector<AurynTime> lazy_trace_time;
+	vector<AurynFloat> lazy_trace_value;
+	/*! Value of the presynaptic trace in the time step before lazy_trace_time[i]. */
+	vector<AurynFloat> lazy_trace_last;
+
+	/*! Sets the state used for lazy updates to the current time and presynaptic traces. */
+	void reset_lazy_state();
+
+	/*! Applies the pending postsynaptic spikes of the neuron with local id post to
+	 * the weight of the synapse from pre, which has to be in the forward matrix. */
+	inline void apply_pending_post_spikes(NeuronID pre, NeuronID post, AurynWeight * weight);
+
+	/*! Marks that the pending spikes have been applied to row pre, which transmits 
+	 * a spike in the current time step. */
+	void update_pending_row(NeuronID pre);
+
+	/*! Records a spike of the postsynaptic neuron with local id post. Its update of each 
+	 * weight is amplitude times the presynaptic trace of the synapse at the time of the spike. */
+	void add_pending_post_spike(NeuronID post, AurynFloat amplitude);
+
 public:
 	ForwardMatrix  * fwd;
 	BackwardMatrix * bkw; // TODO make protected again later when tested
@@ -71,7 +150,48 @@ public:
 
 	virtual ~DuplexConnection();
 	virtual void finalize();
+	/*! Plastic connections read the traces of their source and destination. */
+	virtual bool allows_temporal_blocking();
+	/*! Renumbers the forward matrix and recomputes the backward matrix. */
+	virtual void permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids);
+
+	/*! Toggles lazy updates upon postsynaptic spikes (see the class 
+	 * description). This avoids the traversal of the backward matrix for every 
+	 * postsynaptic spike and pays off when postsynaptic neurons fire at high 
+	 * rates or have many inputs. The presynaptic trace is reconstructed 
+	 * analytically, such that the weights differ from the eager updates by 
+	 * rounding errors. Weights which are read directly from the ForwardMatrix 
+	 * are only up to date after apply_pending_updates. Only supported by 
+	 * connections which set lazy_pre_trace (STDPConnection, 
+	 * SymmetricSTDPConnection and TripletConnection). 
+	 * @param lazy true enables lazy updates.
+	 * @param history_size the number of pending spikes per postsynaptic neuron 
+	 * after which all pending updates are applied. */
+	void set_lazy_updates(bool lazy, unsigned int history_size=DEFAULT_LAZY_HISTORY_SIZE);
+
+	/*! Applies all pending updates of postsynaptic spikes to the weights. */
+	virtual void apply_pending_updates();
 
 };
 
+inline void DuplexConnection::apply_pending_post_spikes(NeuronID pre, NeuronID post, AurynWeight * weight)
+{
+	const vector<PendingPostSpike> & pending = pending_post_spikes[post];
+	const AurynTime since = lazy_row_time[pre];
+	NeuronID k = pending.size();
+	while ( k > 0 && pending[k-1].time >= since ) --k;
+	for ( ; k < pending.size() ; ++k ) {
+		const AurynTime t = pending[k].time;
+		AurynFloat trace = lazy_trace_last[pre];
+		if ( t >= lazy_trace_time[pre] ) {
+			const AurynTime age = t-lazy_trace_time[pre];
+			if ( age >= lazy_decay_table.size() ) continue;
+			trace = lazy_trace_value[pre]*lazy_decay_table[age];
+		}
+		*weight += pending[k].amplitude*trace;
+		// clips too large weights
+		if ( *weight > get_max_weight() ) *weight = get_max_weight();
+	}
+}
+
 #endif /*DUPLEXCONNECTION_H_*/
@@ -43,6 +43,8 @@ void GabaMonitor::init(NeuronGroup * source, NeuronID id, string filename, Auryn
 	if ( ssize < 1 ) ssize = 1;
 
 	nid = id;
+	const NeuronID gid = src->rank2global(nid);
+	if ( gid < src->get_size() ) nid = src->global2rank(src->get_renumbered_id(gid)); // see System::reorder_neurons
 	outfile << setiosflags(ios::fixed) << setprecision(6);
 }
 
@@ -53,3 +55,10 @@ void GabaMonitor::propagate()
 	}
 
 }
+
+void GabaMonitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+	const NeuronID gid = src->rank2global(nid);
+	if ( group != src || gid >= src->get_size() ) return;
+	nid = src->global2rank(new_ids[gid]);
+}
@@ -48,6 +48,8 @@ public:
 	GabaMonitor(NeuronGroup * source, NeuronID id, string filename, AurynTime stepsize=1);
 	virtual ~GabaMonitor();
 	void propagate();
+	/*! Follows the recorded neuron when its group is renumbered */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
 };
 
 #endif /*GABAMONITOR_H_*/
@@ -162,11 +162,70 @@ void IF2Group::check_thresholds()
 
 }
 
+void IF2Group::evolve_fused(NeuronID begin, NeuronID end)
+{
+	const AurynFloat mul_nmda = dt/tau_nmda;
+	const AurynFloat mul_tau_mem = dt/tau_mem;
+	unsigned char spike_flags[FUSED_KERNEL_BLOCK_SIZE];
+
+	AurynState * const mem_ptr = mem->data;
+	AurynState * const thr_ptr = thr->data;
+	AurynState * const ampa_ptr = g_ampa->data;
+	AurynState * const gaba_ptr = g_gaba->data;
+	AurynState * const nmda_ptr = g_nmda->data;
+
+	// same order of operations as in the vectorized version
+#pragma GCC ivdep // the state vectors never overlap
+	for ( NeuronID i = begin ; i < end ; ++i ) {
+		const AurynState ampa = ampa_ptr[i]*scale_ampa;
+		const AurynState gaba = gaba_ptr[i]*scale_gaba;
+		AurynState nmda = nmda_ptr[i];
+		nmda = mul_nmda*ampa + nmda;
+		nmda = -mul_nmda*nmda + nmda;
+
+		AurynState v = mem_ptr[i];
+
+		// NMDA voltage dependence
+		const AurynFloat x = ( v - e_nmda_onset ) * nmda_slope;
+		const AurynFloat x2 = x*x;
+		const AurynFloat r = x2/(1.0+x2);
+		const AurynFloat opening = x > 0 ? r : 0; // rectification
+
+		const AurynState exc = ( -A_ampa*ampa + ( nmda*(-A_nmda) ) * opening ) * v;
+		const AurynState inh = ( v - e_rev ) * gaba;
+		const AurynState leak = v - e_rest;
+
+		v = mul_tau_mem*exc + v;
+		v = -mul_tau_mem*inh + v;
+		v = -mul_tau_mem*leak + v;
+		v = v < 0 ? v : 0;
+		v = v > e_rev ? v : e_rev;
+
+		// threshold check and reset without branches
+		const AurynState th = thr_ptr[i]*scale_thr;
+		const bool spike = v > ( thr_rest + th );
+		spike_flags[i-begin] = spike;
+
+		ampa_ptr[i] = ampa;
+		gaba_ptr[i] = gaba;
+		nmda_ptr[i] = nmda;
+		thr_ptr[i] = spike ? dthr : th; // refractory
+		mem_ptr[i] = spike ? e_rest : v; // reset
+	}
+
+	push_spikes(spike_flags, begin, end);
+}
+
 void IF2Group::evolve()
 {
+#ifdef CODE_USE_FUSED_NEURON_KERNELS
+	for ( NeuronID i = 0 ; i < get_rank_size() ; i += FUSED_KERNEL_BLOCK_SIZE ) 
+		evolve_fused(i, std::min(i+FUSED_KERNEL_BLOCK_SIZE, get_rank_size()));
+#else
 	integrate_nonlinear_nmda_synapses();
 	integrate_membrane();
 	check_thresholds();
+#endif /* CODE_USE_FUSED_NEURON_KERNELS */
 }
 
 
@@ -51,6 +51,10 @@ private:
 	void integrate_membrane();
 	void integrate_nonlinear_nmda_synapses();
 	void check_thresholds();
+	/*! Single pass version of integrate_nonlinear_nmda_synapses, 
+	 * integrate_membrane and check_thresholds for neurons [begin:end).
+	 * Does not update t_leak, t_exc, t_inh and nmda_opening. */
+	void evolve_fused(NeuronID begin, NeuronID end);
 public:
 	IF2Group( NeuronID size, AurynFloat load = 1.0, NeuronID total = 0 );
 	virtual ~IF2Group();
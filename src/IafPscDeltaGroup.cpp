@@ -81,21 +81,26 @@ IafPscDeltaGroup::~IafPscDeltaGroup()
 
 void IafPscDeltaGroup::evolve()
 {
-	for (NeuronID i = 0 ; i < get_rank_size() ; ++i ) {
-    	if (t_ref[i]==0) {
-			if (t_mem[i]>thr) {
-				push_spike(i);
-				t_mem[i] = e_reset ;
-				t_ref[i] += refractory_time ;
-			} else {
-				AurynDouble dg_mem = ( e_rest-t_mem[i] );
-				t_mem[i] += dg_mem*scale_mem;
-			}
-		} else {
-			t_mem[i] = e_reset ;
-			t_ref[i]-- ;
+	unsigned char spike_flags[FUSED_KERNEL_BLOCK_SIZE];
+
+	for ( NeuronID begin = 0 ; begin < get_rank_size() ; begin += FUSED_KERNEL_BLOCK_SIZE ) {
+		const NeuronID end = std::min(begin+FUSED_KERNEL_BLOCK_SIZE, get_rank_size());
+
+		// branch free threshold check, integration, reset and refractoriness
+#pragma GCC ivdep // the state vectors never overlap
+		for (NeuronID i = begin ; i < end ; ++i ) {
+			const AurynFloat m = t_mem[i];
+			const bool active = t_ref[i]==0;
+			const bool spike = active & ( m>thr );
+			const AurynDouble dg_mem = ( e_rest-m );
+			const AurynFloat v = m + dg_mem*scale_mem;
+
+			spike_flags[i-begin] = spike;
+			t_mem[i] = ( active && !spike ) ? v : e_reset;
+			t_ref[i] = active ? ( spike ? refractory_time : 0 ) : t_ref[i]-1;
 		}
 
+		push_spikes(spike_flags, begin, end);
 	}
 }
 
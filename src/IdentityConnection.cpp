@@ -90,6 +90,11 @@ void IdentityConnection::propagate()
 	}
 }
 
+bool IdentityConnection::allows_temporal_blocking()
+{
+	return true;
+}
+
 AurynWeight IdentityConnection::get_data(NeuronID i)
 {
 	return 0;
@@ -142,7 +147,7 @@ bool IdentityConnection::load_from_file(string filename)
 }
 
 
-vector<neuron_pair> IdentityConnection::get_block(NeuronID lo_row, NeuronID lo_col, NeuronID hi_row,  NeuronID hi_col) 
+vector<neuron_pair> IdentityConnection::get_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_col, NeuronID hi_col) 
 {
 	vector<neuron_pair> clist;
 	for ( NeuronID i = lo_row ; i < hi_row ; ++i ) {
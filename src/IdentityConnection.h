@@ -73,6 +73,7 @@ public:
 	void finalize();
 	AurynLong get_nonzero();
 	virtual void propagate();
+	virtual bool allows_temporal_blocking();
 
 	virtual AurynDouble sum();
 	virtual void stats(AurynFloat &mean, AurynFloat &std);
@@ -81,7 +82,7 @@ public:
 	virtual AurynFloat mean();
 
 	/*! Returns a vector of ConnectionsID of a block specified by the arguments */
-	vector<neuron_pair> get_block(NeuronID lo_row, NeuronID lo_col, NeuronID hi_row,  NeuronID hi_col);
+	vector<neuron_pair> get_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_col, NeuronID hi_col);
 
 };
 
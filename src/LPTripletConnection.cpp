@@ -207,11 +207,11 @@ void LPTripletConnection::propagate_backward()
 			// loop over all presynaptic partners
 			for (const NeuronID * c = bkw->get_row_begin(*spike) ; c != bkw->get_row_end(*spike) ; ++c ) {
 				// define shortcut
-				AurynWeight * current_element = bkw->get_data(c);
+				AurynWeight * current_element = get_bkw_weight_ptr(c);
 
 				#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
 				// prefetches next memory cells to reduce number of last-level cache misses
-				_mm_prefetch((const char *)(current_element+2),  _MM_HINT_NTA);
+				_mm_prefetch((const char *)get_bkw_weight_ptr(c+2),  _MM_HINT_NTA);
 				#endif
 
 				// computes plasticity update
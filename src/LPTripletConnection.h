@@ -78,7 +78,7 @@ protected:
 	AurynWeight * fwd_data;
 
 	NeuronID * bkw_ind; 
-	AurynWeight ** bkw_data;
+	AurynInt * bkw_data;
 
 	AurynDouble hom_fudge;
 
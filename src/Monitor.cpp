@@ -66,3 +66,16 @@ void Monitor::free()
 	outfile.close();
 }
 
+string Monitor::get_filename()
+{
+	return fname;
+}
+
+void Monitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+}
+
+SpikingGroup * Monitor::get_source()
+{
+	return NULL;
+}
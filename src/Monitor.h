@@ -33,6 +33,7 @@
 using namespace std;
 
 class System;
+class SpikingGroup;
 
 /*! \brief Abstract base class for all Monitor objects.
  * 
@@ -65,6 +66,17 @@ public:
 	virtual ~Monitor();
 	/*! Virtual propagate function to be called in central simulation loop in System */
 	virtual void propagate() = 0;
+	/*! Returns the output filename */
+	string get_filename();
+	/*! Called by System::reorder_neurons after neuron i of group has become 
+	 * neuron new_ids[i]. Monitors which keep neuron ids or pointers to the 
+	 * state of neurons or synapses update them here. Does nothing by default. */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
+	/*! Returns the SpikingGroup this Monitor exclusively records from or NULL. 
+	 * With temporal blocking (System::set_temporal_blocking) Monitors with a 
+	 * source are run together with their group. Returns NULL by default, 
+	 * which disables temporal blocking. */
+	virtual SpikingGroup * get_source();
 };
 
 extern System * sys;
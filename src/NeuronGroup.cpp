@@ -27,6 +27,7 @@
 
 NeuronGroup::NeuronGroup(NeuronID n, double loadmultiplier, NeuronID total ) : SpikingGroup(n, loadmultiplier, total )
 {
+	evolve_concurrently_bool = true; // integration only touches the group's own state vectors
 	if ( evolve_locally() ) init();
 }
 
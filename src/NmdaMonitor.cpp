@@ -41,6 +41,8 @@ void NmdaMonitor::init(NeuronGroup * source, NeuronID id, string filename, Auryn
 	src = source;
 	ssize = stepsize;
 	nid = id;
+	const NeuronID gid = src->rank2global(nid);
+	if ( gid < src->get_size() ) nid = src->global2rank(src->get_renumbered_id(gid)); // see System::reorder_neurons
 
 	outfile << setiosflags(ios::fixed) << setprecision(6);
 }
@@ -51,3 +53,10 @@ void NmdaMonitor::propagate()
 		outfile << dt*(sys->get_clock()) << " " << src->get_nmda(nid) << "\n";
 	}
 }
+
+void NmdaMonitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+	const NeuronID gid = src->rank2global(nid);
+	if ( group != src || gid >= src->get_size() ) return;
+	nid = src->global2rank(new_ids[gid]);
+}
@@ -81,7 +81,8 @@ void PatternMonitor::propagate()
 	if ( src->evolve_locally() ) {
 		for ( SpikeContainer::const_iterator iter = src->get_spikes_immediate()->begin() ;
 				iter != src->get_spikes_immediate()->end() ; ++iter ) {
-			counter[src->global2rank(*iter)] += 1; // might be more memory efficent to count here in rankIDs (local)
+			// counts by original id since the patterns refer to them (see System::reorder_neurons)
+			counter[src->global2rank(src->get_original_id(*iter))] += 1; // might be more memory efficent to count here in rankIDs (local)
 		}
 
 		if (sys->get_clock()%ssize==0) {
@@ -62,3 +62,8 @@ void PopulationRateMonitor::propagate()
 		}
 	}
 }
+
+SpikingGroup * PopulationRateMonitor::get_source()
+{
+	return src;
+}
@@ -68,6 +68,8 @@ public:
 	virtual ~PopulationRateMonitor();
 	/*! Implementation of necessary propagate() function. */
 	void propagate();
+	/*! Returns the source group (see Monitor::get_source) */
+	virtual SpikingGroup * get_source();
 };
 
 #endif /*POPULATIONRATEMONITOR_H_*/
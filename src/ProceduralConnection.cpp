@@ -0,0 +1,249 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#include "ProceduralConnection.h"
+
+AurynLong ProceduralConnection::instance_counter = 0;
+
+ProceduralConnection::ProceduralConnection( SpikingGroup * source, NeuronGroup * destination, 
+		AurynWeight weight, AurynFloat sparseness,
+		TransmitterType transmitter, string name) 
+: Connection(source,destination,transmitter,name)
+{
+	init(weight, sparseness);
+}
+
+ProceduralConnection::~ProceduralConnection()
+{
+	free();
+}
+
+void ProceduralConnection::init(AurynWeight weight, AurynFloat sparseness) 
+{
+	if ( dst->evolve_locally() == true )
+		sys->register_connection(this);
+
+	skip_diagonal = ( src == dst );
+	if ( skip_diagonal ) {
+		stringstream oss;
+		oss << "ProceduralConnection: ("<< get_name() <<"): Detected recurrent connection. skip_diagonal was activated!";
+		logger->msg(oss.str(),DEBUG);
+	}
+
+	connection_weight = weight;
+	this->sparseness = sparseness;
+	log_q = 0.0;
+	if ( sparseness > 0.0 && sparseness < 1.0 ) 
+		log_q = std::log(1.0-sparseness);
+
+	// same column layout as SparseConnection on distributed groups
+	stride = dst->get_locked_range();
+	offset = 0;
+	jdim = 0;
+	if ( dst->evolve_locally() && sparseness > 0.0 ) {
+		offset = communicator->rank()-dst->get_locked_rank();
+		jdim = dst->get_rank_size();
+	}
+
+	// connections are created in the same order on all ranks
+	set_seed( CounterRandomStream::mix(++instance_counter) );
+
+	stringstream oss;
+	oss << "ProceduralConnection: ("<< get_name() <<"): Initialized with weight "
+		<< weight << " and sparseness " << sparseness;
+	logger->msg(oss.str(),DEBUG);
+}
+
+void ProceduralConnection::free()
+{
+}
+
+void ProceduralConnection::finalize()
+{
+}
+
+void ProceduralConnection::set_seed(AurynLong s)
+{
+	seed = s;
+	n_nonzero = count_nonzero();
+	stringstream oss;
+	oss << "ProceduralConnection: ("<< get_name() <<"): Seed " << seed 
+		<< " with " << n_nonzero << " synapses on this rank";
+	logger->msg(oss.str(),DEBUG);
+}
+
+AurynLong ProceduralConnection::get_seed()
+{
+	return seed;
+}
+
+void ProceduralConnection::set_weight(AurynWeight weight)
+{
+	connection_weight = weight;
+}
+
+AurynWeight ProceduralConnection::get_weight()
+{
+	return connection_weight;
+}
+
+void ProceduralConnection::propagate()
+{
+	CounterRandomStream stream(seed,0);
+	SpikeContainer::const_iterator spikes_end = src->get_spikes()->end();
+	for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
+			spike != spikes_end ; ++spike ) {
+		const NeuronID i = *spike;
+		for ( AurynLong x = row_begin(stream,i) ; x < jdim ; x = row_next(stream,x) ) {
+			// x is already the rank local index of the target
+			if ( skip_diagonal && global_col(x) == i ) continue;
+			target[x] += connection_weight;
+		}
+	}
+}
+
+bool ProceduralConnection::allows_temporal_blocking()
+{
+	return true;
+}
+
+AurynWeight ProceduralConnection::get_data(NeuronID i)
+{
+	return connection_weight;
+}
+
+bool ProceduralConnection::exists(NeuronID i, NeuronID j)
+{
+	if ( !dst->localrank(j) || ( skip_diagonal && i == j ) ) return false;
+	const AurynLong xj = dst->global2rank(j);
+	CounterRandomStream stream(seed,0);
+	for ( AurynLong x = row_begin(stream,i) ; x <= xj && x < jdim ; x = row_next(stream,x) ) {
+		if ( x == xj ) return true;
+	}
+	return false;
+}
+
+AurynWeight ProceduralConnection::get(NeuronID i, NeuronID j)
+{
+	if ( !exists(i,j) ) return 0;
+	return connection_weight;
+}
+
+AurynWeight * ProceduralConnection::get_ptr(NeuronID i, NeuronID j)
+{
+	return NULL;
+}
+
+void ProceduralConnection::set(NeuronID i, NeuronID j, AurynWeight value)
+{
+}
+
+AurynLong ProceduralConnection::get_nonzero()
+{
+	return n_nonzero;
+}
+
+AurynLong ProceduralConnection::count_nonzero()
+{
+	AurynLong count = 0;
+	CounterRandomStream stream(seed,0);
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		for ( AurynLong x = row_begin(stream,i) ; x < jdim ; x = row_next(stream,x) ) {
+			if ( skip_diagonal && global_col(x) == i ) continue;
+			++count;
+		}
+	}
+	return count;
+}
+
+void ProceduralConnection::stats(AurynFloat &mean, AurynFloat &std)
+{
+	mean = connection_weight;
+	std = 0;
+}
+
+AurynDouble ProceduralConnection::sum()
+{
+	return connection_weight*get_nonzero();
+}
+
+bool ProceduralConnection::write_to_file(string filename)
+{
+	if ( !dst->evolve_locally() ) return true;
+
+	ofstream outfile;
+	outfile.open(filename.c_str(),ios::out);
+	if (!outfile) {
+		stringstream oss;
+		oss << "Can't open output file " << filename;
+		logger->msg(oss.str(),ERROR);
+		throw AurynOpenFileException();
+	}
+
+	outfile << "%%MatrixMarket matrix coordinate real general\n" 
+		<< "% Auryn weight matrix. Has to be kept in row major order for load operation.\n" 
+		<< "% Connection name: " << get_name() << "\n"
+		<< "% Locked range: " << dst->get_locked_range() << "\n"
+		<< "%\n"
+		<< get_m_rows() << " " << get_n_cols() << " " << get_nonzero() << endl;
+
+	CounterRandomStream stream(seed,0);
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		outfile << setprecision(7);
+		for ( AurynLong x = row_begin(stream,i) ; x < jdim ; x = row_next(stream,x) ) {
+			const NeuronID j = global_col(x);
+			if ( skip_diagonal && j == i ) continue;
+			outfile << i+1 << " " << j+1 << " " << scientific << connection_weight << fixed << "\n";
+		}
+	}
+
+	outfile.close();
+	return true;
+}
+
+bool ProceduralConnection::load_from_file(string filename)
+{
+	stringstream oss;
+	oss << "ProceduralConnection: ("<< get_name() <<"): Loading from file is not supported.";
+	logger->msg(oss.str(),WARNING);
+	return false;
+}
+
+vector<neuron_pair> ProceduralConnection::get_block(NeuronID lo_row, NeuronID hi_row,  NeuronID lo_col, NeuronID hi_col) 
+{
+	vector<neuron_pair> clist;
+	CounterRandomStream stream(seed,0);
+	for ( NeuronID i = lo_row ; i < hi_row ; ++i ) {
+		for ( AurynLong x = row_begin(stream,i) ; x < jdim ; x = row_next(stream,x) ) {
+			const NeuronID j = global_col(x);
+			if ( j < lo_col || j >= hi_col || ( skip_diagonal && j == i ) ) continue;
+			neuron_pair a;
+			a.i = i;
+			a.j = j;
+			clist.push_back( a );
+		}
+	}
+	return clist;
+}
@@ -0,0 +1,153 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#ifndef PROCEDURALCONNECTION_H_
+#define PROCEDURALCONNECTION_H_
+
+#include "auryn_definitions.h"
+#include "Connection.h"
+#include "System.h"
+#include "CounterRandomStream.h"
+
+#include <sstream>
+#include <fstream>
+
+using namespace std;
+
+/*! \brief Static random connectivity with uniform weights which is 
+ * regenerated on the fly instead of being stored
+ *
+ * Each presynaptic neuron i connects to each postsynaptic neuron with 
+ * probability sparseness. Instead of storing the synapses in a weight matrix,
+ * the targets of neuron i are redrawn from a CounterRandomStream with the 
+ * stream id i each time i spikes. This replaces reading the column indices 
+ * from memory by a few arithmetic operations per synapse and allows to simulate
+ * networks whose static connectivity would not fit into memory. 
+ *
+ * Since there is no weight matrix the connectivity cannot be changed after it
+ * was created. All synapses share the same weight which can be changed with 
+ * set_weight. The connectivity is determined by the seed (see set_seed) and 
+ * the number of ranks.
+ */
+class ProceduralConnection : public Connection
+{
+private:
+	static AurynLong instance_counter;
+
+	AurynWeight connection_weight;
+	AurynFloat sparseness;
+	AurynLong seed;
+	bool skip_diagonal;
+
+	/*! Precomputed log(1-sparseness) */
+	AurynDouble log_q;
+	/*! Number of postsynaptic neurons on this rank */
+	AurynLong jdim;
+	/*! Stride and offset of the global ids of the local postsynaptic neurons */
+	NeuronID stride, offset;
+	/*! Number of synapses on this rank. Computed by count_nonzero whenever 
+	 * the seed changes. */
+	AurynLong n_nonzero;
+
+	void init(AurynWeight weight, AurynFloat sparseness);
+
+	/*! Sets up the stream of the row i and returns the local index of the 
+	 * first target in that row. */
+	inline AurynLong row_begin(CounterRandomStream & stream, NeuronID i);
+	/*! Returns the local index of the target that follows x in the current row. */
+	inline AurynLong row_next(CounterRandomStream & stream, AurynLong x);
+	/*! Returns the global postsynaptic id of local index x */
+	inline NeuronID global_col(AurynLong x);
+
+	/*! Counts the synapses on this rank by drawing all rows. */
+	AurynLong count_nonzero();
+	/*! Returns true if the synapse from i to j exists on this rank. */
+	bool exists(NeuronID i, NeuronID j);
+
+protected:
+	void free();
+
+public:
+	ProceduralConnection(SpikingGroup * source, NeuronGroup * destination, 
+			AurynWeight weight, AurynFloat sparseness=0.05, 
+			TransmitterType transmitter=GLUT, string name="ProceduralConnection");
+	virtual ~ProceduralConnection();
+
+	/*! Sets the seed of the random streams from which the connectivity 
+	 * is drawn. Per default each ProceduralConnection uses a different seed 
+	 * derived from the order in which the connections were created. */
+	void set_seed(AurynLong s);
+	AurynLong get_seed();
+
+	/*! Sets the weight of all synapses. */
+	void set_weight(AurynWeight weight);
+	AurynWeight get_weight();
+
+	virtual AurynWeight get(NeuronID i, NeuronID j);
+	/*! Returns NULL since the synapses share a single weight. */
+	virtual AurynWeight * get_ptr(NeuronID i, NeuronID j);
+	virtual AurynWeight get_data(NeuronID i);
+	/*! Does nothing since the weights are not stored individually. */
+	virtual void set(NeuronID i, NeuronID j, AurynWeight value);
+	/*! Returns the number of synapses on this rank. */
+	virtual AurynLong get_nonzero();
+
+	virtual void finalize();
+	virtual void propagate();
+	virtual bool allows_temporal_blocking();
+
+	virtual AurynDouble sum();
+	virtual void stats(AurynFloat &mean, AurynFloat &std);
+
+	/*! Writes the synapses on this rank as a matrix market file in the same 
+	 * format as SparseConnection::write_to_file. */
+	virtual bool write_to_file(string filename);
+	/*! Not supported since the connectivity is given by the seed. */
+	virtual bool load_from_file(string filename);
+
+	/*! Returns a vector of ConnectionsID of a block specified by the arguments */
+	vector<neuron_pair> get_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_col, NeuronID hi_col);
+};
+
+inline AurynLong ProceduralConnection::row_begin(CounterRandomStream & stream, NeuronID i)
+{
+	// the stream id includes the rank offset so that ranks draw independently
+	stream.set_stream(seed, (AurynLong)i*stride+offset);
+	if ( sparseness >= 1.0 ) return 0;
+	return stream.geometric(log_q,jdim);
+}
+
+inline AurynLong ProceduralConnection::row_next(CounterRandomStream & stream, AurynLong x)
+{
+	if ( sparseness >= 1.0 ) return x+1;
+	return x+1+stream.geometric(log_q,jdim);
+}
+
+inline NeuronID ProceduralConnection::global_col(AurynLong x)
+{
+	return x*stride+offset;
+}
+
+#endif /*PROCEDURALCONNECTION_H_*/
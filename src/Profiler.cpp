@@ -0,0 +1,222 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#include "Profiler.h"
+#include "auryn_global.h"
+
+Profiler::Profiler()
+{
+	num_shared = 0;
+	reset();
+}
+
+Profiler::~Profiler()
+{
+}
+
+unsigned int Profiler::add_entry(string phase, string name, bool shared)
+{
+	phases.push_back(phase);
+	names.push_back(name);
+	shared_ids.push_back( shared ? num_shared++ : -1 );
+	times.push_back(0.0);
+	calls.push_back(0);
+	spikes.push_back(0);
+	synapses.push_back(0);
+	return phases.size()-1;
+}
+
+void Profiler::clear()
+{
+	phases.clear();
+	names.clear();
+	shared_ids.clear();
+	num_shared = 0;
+	times.clear();
+	calls.clear();
+	spikes.clear();
+	synapses.clear();
+}
+
+void Profiler::reset()
+{
+	for ( unsigned int i = 0 ; i < get_size() ; ++i ) {
+		times[i] = 0.0;
+		calls[i] = 0;
+		spikes[i] = 0;
+		synapses[i] = 0;
+	}
+	measurement_start = get_wall_time();
+}
+
+unsigned int Profiler::get_size()
+{
+	return phases.size();
+}
+
+AurynDouble Profiler::get_time(unsigned int i)
+{
+	return times[i];
+}
+
+void Profiler::report(mpi::communicator * com, string filename)
+{
+	AurynDouble elapsed = get_wall_time()-measurement_start;
+
+	vector< vector<string> > all_phases;
+	vector< vector<string> > all_names;
+	vector< vector<int> > all_shared_ids;
+	vector< vector<AurynDouble> > all_times;
+	vector< vector<AurynLong> > all_calls;
+	vector< vector<AurynLong> > all_spikes;
+	vector< vector<AurynLong> > all_synapses;
+
+	gather(*com, phases, all_phases, 0);
+	gather(*com, names, all_names, 0);
+	gather(*com, shared_ids, all_shared_ids, 0);
+	gather(*com, times, all_times, 0);
+	gather(*com, calls, all_calls, 0);
+	gather(*com, spikes, all_spikes, 0);
+	gather(*com, synapses, all_synapses, 0);
+
+	if ( com->rank() != 0 ) return;
+
+	// merge entries -- shared entries are keyed by (-1,id), rank-local ones by (rank,index)
+	map< pair<int,int>, unsigned int > index;
+	vector<string> r_phases;
+	vector<string> r_names;
+	vector<int> r_ranks;
+	vector<AurynDouble> r_sum_times;
+	vector<AurynDouble> r_max_times;
+	vector<AurynLong> r_calls;
+	vector<AurynLong> r_spikes;
+	vector<AurynLong> r_synapses;
+
+	for ( unsigned int r = 0 ; r < all_phases.size() ; ++r ) {
+		for ( unsigned int i = 0 ; i < all_phases[r].size() ; ++i ) {
+			pair<int,int> key(-1,all_shared_ids[r][i]);
+			if ( all_shared_ids[r][i] < 0 ) key = make_pair(r,i);
+
+			map< pair<int,int>, unsigned int >::iterator it = index.find(key);
+			if ( it == index.end() ) {
+				index[key] = r_phases.size();
+				r_phases.push_back(all_phases[r][i]);
+				r_names.push_back(all_names[r][i]);
+				r_ranks.push_back(0);
+				r_sum_times.push_back(0.0);
+				r_max_times.push_back(0.0);
+				r_calls.push_back(0);
+				r_spikes.push_back(0);
+				r_synapses.push_back(0);
+				it = index.find(key);
+			}
+
+			unsigned int k = it->second;
+			r_ranks[k]++;
+			r_sum_times[k] += all_times[r][i];
+			r_max_times[k] = max(r_max_times[k],all_times[r][i]);
+			r_calls[k] = max(r_calls[k],all_calls[r][i]);
+			r_spikes[k] += all_spikes[r][i];
+			r_synapses[k] += all_synapses[r][i];
+		}
+	}
+
+	const int n = r_phases.size();
+
+	// rank entries by time summed over all ranks
+	vector< pair<AurynDouble,int> > ranking;
+	AurynDouble total = 0.0;
+	for ( int i = 0 ; i < n ; ++i ) {
+		ranking.push_back( make_pair(-r_sum_times[i],i) );
+		total += r_sum_times[i];
+	}
+	sort(ranking.begin(), ranking.end());
+
+	const int ranks = com->size();
+	const AurynDouble walltime = elapsed*ranks;
+
+	stringstream oss;
+	oss << "Profile of the last run (" 
+		<< elapsed << "s wall time on " << ranks << " ranks, " 
+		<< setprecision(3) << 100.0*total/walltime << "% thereof in profiled phases)";
+	logger->msg(oss.str(),PROGRESS,true);
+
+	oss.str("");
+	oss << setw(4) << "#" << " " 
+		<< setw(12) << "phase" << " " 
+		<< setw(24) << "name" << " " 
+		<< setw(10) << "mean[s]" << " " 
+		<< setw(10) << "max[s]" << " " 
+		<< setw(8) << "share[%]" << " " 
+		<< setw(10) << "calls" << " " 
+		<< setw(12) << "spikes" << " " 
+		<< setw(14) << "synapses";
+	logger->msg(oss.str(),PROGRESS,true);
+
+	for ( int k = 0 ; k < n ; ++k ) {
+		int i = ranking[k].second;
+		string name = r_names[i];
+		if ( name.size() > 24 ) name = name.substr(name.size()-24);
+		oss.str("");
+		oss << setw(4) << k+1 << " " 
+			<< setw(12) << r_phases[i] << " " 
+			<< setw(24) << name << " " 
+			<< setw(10) << setprecision(4) << r_sum_times[i]/r_ranks[i] << " " 
+			<< setw(10) << setprecision(4) << r_max_times[i] << " " 
+			<< setw(8) << setprecision(3) << 100.0*r_sum_times[i]/walltime << " " 
+			<< setw(10) << r_calls[i] << " " 
+			<< setw(12) << r_spikes[i] << " " 
+			<< setw(14) << r_synapses[i];
+		logger->msg(oss.str(),PROGRESS,true);
+	}
+
+	if ( filename.empty() ) return;
+
+	ofstream outfile;
+	outfile.open(filename.c_str(),ios::out);
+	if (!outfile) {
+		oss.str("");
+		oss << "Can't open profiler output file " << filename;
+		logger->msg(oss.str(),ERROR);
+		return;
+	}
+
+	outfile << "# walltime " << elapsed << " ranks " << ranks << endl;
+	outfile << "# phase name ranks time_mean time_max calls spikes synapses" << endl;
+	for ( int k = 0 ; k < n ; ++k ) {
+		int i = ranking[k].second;
+		string name = r_names[i];
+		replace(name.begin(), name.end(), ' ', '_');
+		outfile << r_phases[i] << " " 
+			<< name << " " 
+			<< r_ranks[i] << " " 
+			<< r_sum_times[i]/r_ranks[i] << " " 
+			<< r_max_times[i] << " " 
+			<< r_calls[i] << " " 
+			<< r_spikes[i] << " " 
+			<< r_synapses[i] << endl;
+	}
+	outfile.close();
+}
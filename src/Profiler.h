@@ -0,0 +1,118 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "auryn_definitions.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+#include <mpi.h>
+
+using namespace std;
+namespace mpi = boost::mpi;
+
+/*! \brief Accumulates wall time and work counters for the phases of a simulation
+ *
+ * Each entry corresponds to one phase of one registered object (e.g. the evolve 
+ * of a SpikingGroup or the propagate of a Connection). System creates the entries 
+ * when profiling is enabled (System::set_profiling) and adds to them during run().
+ * At the end of a run the entries are gathered on rank 0 and printed as a table
+ * ranked by time. Entries of objects which exist on all ranks are merged, while 
+ * entries of objects which only exist on some ranks (e.g. most Monitors) are 
+ * listed per rank.
+ *
+ * Different entries can be updated concurrently from different threads, but a 
+ * single entry must only be updated from one thread at a time.
+ */
+class Profiler
+{
+private:
+	vector<string> phases;
+	vector<string> names;
+	/*! Position of the entry among the entries shared by all ranks or -1 for rank-local entries */
+	vector<int> shared_ids;
+	int num_shared;
+	vector<AurynDouble> times;
+	vector<AurynLong> calls;
+	vector<AurynLong> spikes;
+	vector<AurynLong> synapses;
+
+	AurynDouble measurement_start;
+
+public:
+	Profiler();
+	virtual ~Profiler();
+
+	/*! Adds an entry and returns its index 
+	 * \param phase Short name of the phase (e.g. "evolve")
+	 * \param name Name of the object this entry belongs to 
+	 * \param shared Set to true if the entry is created in the same order on all ranks */
+	unsigned int add_entry(string phase, string name, bool shared=true);
+
+	/*! Removes all entries */
+	void clear();
+
+	/*! Sets all counters to zero and restarts the wall time of the measurement */
+	void reset();
+
+	/*! Returns the number of entries */
+	unsigned int get_size();
+
+	/*! Returns the wall time accumulated by entry i on this rank */
+	AurynDouble get_time(unsigned int i);
+
+	/*! Returns the current wall time in seconds */
+	static AurynDouble get_wall_time() 
+	{
+		return MPI_Wtime();
+	}
+
+	/*! Adds a single call to entry i 
+	 * \param i Index of the entry as returned by add_entry
+	 * \param t Wall time spent in the call
+	 * \param nspikes Number of spikes processed in the call
+	 * \param nsynapses Number of synapses touched in the call */
+	void add(unsigned int i, AurynDouble t, AurynLong nspikes=0, AurynLong nsynapses=0)
+	{
+		times[i] += t;
+		calls[i]++;
+		spikes[i] += nspikes;
+		synapses[i] += nsynapses;
+	}
+
+	/*! Gathers all entries on rank 0 and prints a table ranked by the time summed over ranks.
+	 * Has to be called collectively on all ranks.
+	 * \param com The communicator to reduce over
+	 * \param filename If not empty rank 0 writes the reduced entries to this 
+	 * file (one entry per line, white space separated) */
+	void report(mpi::communicator * com, string filename="");
+};
+
+#endif /*PROFILER_H_*/
@@ -0,0 +1,453 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#include "QuantizedConnection.h"
+
+QuantizedConnection::QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+		QuantizationType quantization, TransmitterType transmitter) 
+: SparseConnection(source, destination, transmitter)
+{
+	allocate(1);
+	w->fill_zeros();
+	init(quantization);
+}
+
+QuantizedConnection::QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+		const char * filename, 
+		QuantizationType quantization, TransmitterType transmitter) 
+: SparseConnection(source, destination, filename, transmitter)
+{
+	init(quantization);
+}
+
+QuantizedConnection::QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+		AurynWeight weight, AurynFloat sparseness, 
+		QuantizationType quantization, TransmitterType transmitter, string name) 
+: SparseConnection(source, destination, weight, sparseness, transmitter, name)
+{
+	init(quantization);
+}
+
+QuantizedConnection::~QuantizedConnection()
+{
+	free_quantized();
+}
+
+void QuantizedConnection::init(QuantizationType q)
+{
+	quantization = q;
+	qw16 = NULL;
+	qw8 = NULL;
+	rms_error = 0;
+	max_error = 0;
+	quantize();
+}
+
+void QuantizedConnection::free_quantized()
+{
+	delete qw16;
+	delete qw8;
+	qw16 = NULL;
+	qw8 = NULL;
+}
+
+QuantizationType QuantizedConnection::get_quantization()
+{
+	return quantization;
+}
+
+template <typename Q> 
+ComplexMatrix<Q> * QuantizedConnection::copy_structure()
+{
+	const AurynLong nnz = w->get_nonzero();
+	ComplexMatrix<Q> * m = new ComplexMatrix<Q>(get_m_rows(), get_n_cols(), std::max(nnz,(AurynLong)1));
+	vector<AurynLong> sizes(get_m_rows());
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
+		sizes[i] = w->get_row_end(i)-w->get_row_begin(i);
+	if ( get_m_rows() ) m->set_row_sizes(&sizes[0]);
+	std::copy(w->get_ind_begin(), w->get_ind_begin()+nnz, m->get_ind_begin());
+	return m;
+}
+
+void QuantizedConnection::quantize()
+{
+	// nothing to do when the matrix was quantized already
+	if ( w->get_nonzero() == 0 && ( qw16 != NULL || qw8 != NULL ) ) return;
+
+	free_quantized();
+
+	if ( quantization == QUANT_INT8 ) {
+		qw8 = copy_structure<signed char>();
+		row_scales.assign(get_m_rows(), 1.0);
+		for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+			AurynWeight maxabs = 0;
+			for ( NeuronID * c = w->get_row_begin(i) ; c != w->get_row_end(i) ; ++c ) 
+				maxabs = std::max(maxabs, std::abs(w->get_value(c)));
+			if ( maxabs > 0 ) row_scales[i] = maxabs/127;
+		}
+	} else {
+		qw16 = copy_structure<unsigned short>();
+	}
+
+	// convert and measure the quantization error
+	double sum2 = 0;
+	max_error = 0;
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		for ( NeuronID * c = w->get_row_begin(i) ; c != w->get_row_end(i) ; ++c ) {
+			const AurynLong k = c-w->get_ind_begin();
+			const AurynWeight value = w->get_value(c);
+			set_value(i, k, value);
+			const AurynFloat err = std::abs(get_value(i, k)-value);
+			sum2 += err*err;
+			max_error = std::max(max_error, err);
+		}
+	}
+	rms_error = w->get_nonzero() ? std::sqrt(sum2/w->get_nonzero()) : 0;
+
+	stringstream oss;
+	oss << "QuantizedConnection: ("<< get_name() <<"): Quantized " 
+		<< w->get_nonzero() << " weights with rms error " << rms_error 
+		<< " and max error " << max_error;
+	logger->msg(oss.str(),NOTIFICATION);
+
+	// free the single precision weights
+	w->resize_buffer_and_clear(1);
+	w->fill_zeros();
+}
+
+ForwardMatrix * QuantizedConnection::dequantize()
+{
+	const AurynLong nnz = get_nonzero();
+	ForwardMatrix * m = new ForwardMatrix(get_m_rows(), get_n_cols(), std::max(nnz,(AurynLong)1));
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		if ( quantization == QUANT_INT8 ) {
+			for ( NeuronID * c = qw8->get_row_begin(i) ; c != qw8->get_row_end(i) ; ++c ) 
+				m->push_back(i, *c, get_value(i, c-qw8->get_ind_begin()));
+		} else {
+			for ( NeuronID * c = qw16->get_row_begin(i) ; c != qw16->get_row_end(i) ; ++c ) 
+				m->push_back(i, *c, get_value(i, c-qw16->get_ind_begin()));
+		}
+	}
+	m->fill_zeros();
+	return m;
+}
+
+NeuronID QuantizedConnection::row_of(AurynLong k)
+{
+	NeuronID ** rowptrs;
+	NeuronID * ind;
+	if ( quantization == QUANT_INT8 ) {
+		rowptrs = qw8->get_rowptrs();
+		ind = qw8->get_ind_begin();
+	} else {
+		rowptrs = qw16->get_rowptrs();
+		ind = qw16->get_ind_begin();
+	}
+	// last row whose begin is not behind element k
+	NeuronID ** r = std::upper_bound(rowptrs, rowptrs+get_m_rows(), ind+k);
+	return r-rowptrs-1;
+}
+
+AurynWeight QuantizedConnection::get_value(NeuronID i, AurynLong k)
+{
+	switch ( quantization ) {
+		case QUANT_INT8:
+			return row_scales[i]*qw8->get_value(k);
+		case QUANT_BF16:
+			return bfloat16_to_float(qw16->get_value(k));
+		default:
+			return half_to_float(qw16->get_value(k));
+	}
+}
+
+void QuantizedConnection::set_value(NeuronID i, AurynLong k, AurynWeight value)
+{
+	switch ( quantization ) {
+		case QUANT_INT8:
+			{
+				// values outside of the range of the row are clipped
+				const AurynFloat q = std::floor(value/row_scales[i]+0.5f);
+				qw8->set_data(k, (signed char) std::max(-127.0f,std::min(127.0f,q)));
+			}
+			break;
+		case QUANT_BF16:
+			qw16->set_data(k, float_to_bfloat16(value));
+			break;
+		default:
+			qw16->set_data(k, float_to_half(value));
+	}
+}
+
+AurynLong QuantizedConnection::get_nonzero()
+{
+	if ( quantization == QUANT_INT8 ) 
+		return qw8->get_nonzero();
+	return qw16->get_nonzero();
+}
+
+AurynWeight QuantizedConnection::get(NeuronID i, NeuronID j)
+{
+	if ( quantization == QUANT_INT8 ) {
+		signed char * ptr = qw8->get_ptr(i,j);
+		if ( ptr == NULL ) return 0;
+		return get_value(i, ptr-qw8->get_data_begin());
+	} else {
+		unsigned short * ptr = qw16->get_ptr(i,j);
+		if ( ptr == NULL ) return 0;
+		return get_value(i, ptr-qw16->get_data_begin());
+	}
+}
+
+AurynWeight * QuantizedConnection::get_ptr(NeuronID i, NeuronID j)
+{
+	return NULL;
+}
+
+AurynWeight QuantizedConnection::get_data(NeuronID i)
+{
+	return get_value(row_of(i), i);
+}
+
+void QuantizedConnection::set_data(NeuronID i, AurynWeight value)
+{
+	set_value(row_of(i), i, value);
+}
+
+void QuantizedConnection::set(NeuronID i, NeuronID j, AurynWeight value)
+{
+	if ( quantization == QUANT_INT8 ) {
+		signed char * ptr = qw8->get_ptr(i,j);
+		if ( ptr != NULL ) set_value(i, ptr-qw8->get_data_begin(), value);
+	} else {
+		unsigned short * ptr = qw16->get_ptr(i,j);
+		if ( ptr != NULL ) set_value(i, ptr-qw16->get_data_begin(), value);
+	}
+}
+
+void QuantizedConnection::set(vector<neuron_pair> element_list, AurynWeight value)
+{
+	for ( vector<neuron_pair>::iterator iter = element_list.begin() ; iter != element_list.end() ; ++iter ) 
+		set( (*iter).i, (*iter).j, value );
+}
+
+void QuantizedConnection::set_all(AurynWeight weight)
+{
+	if ( quantization == QUANT_INT8 ) {
+		const AurynFloat scale = ( weight != 0 ) ? std::abs(weight)/127 : 1;
+		row_scales.assign(get_m_rows(), scale);
+		qw8->set_all( weight > 0 ? 127 : ( weight < 0 ? -127 : 0 ) );
+	} else {
+		set_value(0, 0, weight); // converts the weight once
+		if ( get_nonzero() ) qw16->set_all(qw16->get_value((AurynLong)0));
+	}
+}
+
+void QuantizedConnection::scale_all(AurynFloat value)
+{
+	if ( quantization == QUANT_INT8 ) {
+		for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
+			row_scales[i] *= value;
+		if ( value < 0 ) qw8->scale_all(-1);
+		for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
+			row_scales[i] = std::abs(row_scales[i]);
+		return;
+	}
+	for ( AurynLong k = 0 ; k < get_nonzero() ; ++k ) 
+		set_value(0, k, value*get_value(0, k));
+}
+
+void QuantizedConnection::clip(AurynWeight lo, AurynWeight hi)
+{
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		AurynLong begin, end;
+		if ( quantization == QUANT_INT8 ) {
+			begin = qw8->get_row_begin_index(i);
+			end = qw8->get_row_end_index(i);
+		} else {
+			begin = qw16->get_row_begin_index(i);
+			end = qw16->get_row_end_index(i);
+		}
+		for ( AurynLong k = begin ; k < end ; ++k ) {
+			const AurynWeight value = get_value(i, k);
+			if ( value < lo ) 
+				set_value(i, k, lo);
+			else if ( value > hi ) 
+				set_value(i, k, hi);
+		}
+	}
+}
+
+void QuantizedConnection::finalize()
+{
+	SparseConnection::finalize();
+	quantize();
+}
+
+void QuantizedConnection::propagate()
+{
+	switch ( quantization ) {
+		case QUANT_INT8:
+			{
+				const NeuronID * ind = qw8->get_ind_begin();
+				const signed char * data = qw8->get_data_begin();
+				for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
+						spike != src->get_spikes()->end() ; ++spike ) {
+					const AurynFloat scale = row_scales[*spike];
+					for ( const NeuronID * c = qw8->get_row_begin(*spike) ; c != qw8->get_row_end(*spike) ; ++c ) 
+						transmit( *c , scale*data[c-ind] );
+				}
+			}
+			break;
+		case QUANT_BF16:
+			{
+				const NeuronID * ind = qw16->get_ind_begin();
+				const unsigned short * data = qw16->get_data_begin();
+				for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
+						spike != src->get_spikes()->end() ; ++spike ) {
+					for ( const NeuronID * c = qw16->get_row_begin(*spike) ; c != qw16->get_row_end(*spike) ; ++c ) 
+						transmit( *c , bfloat16_to_float(data[c-ind]) );
+				}
+			}
+			break;
+		default:
+			{
+				const NeuronID * ind = qw16->get_ind_begin();
+				const unsigned short * data = qw16->get_data_begin();
+				for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
+						spike != src->get_spikes()->end() ; ++spike ) {
+					for ( const NeuronID * c = qw16->get_row_begin(*spike) ; c != qw16->get_row_end(*spike) ; ++c ) 
+						transmit( *c , half_to_float(data[c-ind]) );
+				}
+			}
+	}
+}
+
+void QuantizedConnection::permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids)
+{
+	if ( quantization == QUANT_INT8 ) {
+		qw8->permute(pre_ids, post_ids);
+		if ( pre_ids ) {
+			vector<AurynFloat> scales(row_scales.size());
+			for ( NeuronID i = 0 ; i < row_scales.size() ; ++i ) 
+				scales[(*pre_ids)[i]] = row_scales[i];
+			row_scales.swap(scales);
+		}
+	} else {
+		qw16->permute(pre_ids, post_ids);
+	}
+}
+
+AurynDouble QuantizedConnection::sum()
+{
+	AurynDouble sum = 0;
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		if ( quantization == QUANT_INT8 ) {
+			AurynDouble row_sum = 0;
+			for ( AurynLong k = qw8->get_row_begin_index(i) ; k < qw8->get_row_end_index(i) ; ++k ) 
+				row_sum += qw8->get_value(k);
+			sum += row_scales[i]*row_sum;
+		} else {
+			for ( AurynLong k = qw16->get_row_begin_index(i) ; k < qw16->get_row_end_index(i) ; ++k ) 
+				sum += get_value(i, k);
+		}
+	}
+	return sum;
+}
+
+void QuantizedConnection::stats(AurynFloat &mean, AurynFloat &std)
+{
+	AurynDouble sum = 0;
+	AurynDouble sum2 = 0;
+	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) {
+		AurynLong begin, end;
+		if ( quantization == QUANT_INT8 ) {
+			begin = qw8->get_row_begin_index(i);
+			end = qw8->get_row_end_index(i);
+		} else {
+			begin = qw16->get_row_begin_index(i);
+			end = qw16->get_row_end_index(i);
+		}
+		for ( AurynLong k = begin ; k < end ; ++k ) {
+			const AurynWeight value = get_value(i, k);
+			sum  += value;
+			sum2 += value*value;
+		}
+	}
+	const AurynLong count = get_nonzero();
+	if ( count <= 1 ) {
+		mean = sum;
+		std = 0;
+		return;
+	}
+	mean = sum/count;
+	std = std::sqrt(std::max(0.0, sum2/count-(AurynDouble)mean*mean));
+}
+
+void QuantizedConnection::stats(AurynFloat &mean, AurynFloat &std, AurynFloat &rms_err, AurynFloat &max_err)
+{
+	stats(mean, std);
+	rms_err = rms_error;
+	max_err = max_error;
+}
+
+bool QuantizedConnection::write_to_file(string filename)
+{
+	ForwardMatrix * m = dequantize();
+	bool result = SparseConnection::write_to_file(m, filename);
+	delete m;
+	return result;
+}
+
+bool QuantizedConnection::write_to_binary_file(string filename)
+{
+	ForwardMatrix * m = dequantize();
+	bool result = SparseConnection::write_to_binary_file(m, filename);
+	delete m;
+	return result;
+}
+
+vector<neuron_pair> QuantizedConnection::get_block(NeuronID lo_row, NeuronID hi_row,  NeuronID lo_col, NeuronID hi_col) 
+{
+	vector<neuron_pair> clist;
+	for ( NeuronID i = lo_row ; i < std::min(hi_row,get_m_rows()) ; ++i ) {
+		NeuronID * begin, * end;
+		if ( quantization == QUANT_INT8 ) {
+			begin = qw8->get_row_begin(i);
+			end = qw8->get_row_end(i);
+		} else {
+			begin = qw16->get_row_begin(i);
+			end = qw16->get_row_end(i);
+		}
+		for ( NeuronID * j = begin ; j != end ; ++j ) {
+			if ( *j >= lo_col && *j < hi_col ) {
+				neuron_pair a;
+				a.i = i;
+				a.j = *j;
+				clist.push_back( a );
+			}
+		}
+	}
+	return clist;
+}
@@ -0,0 +1,225 @@
+/* 
+* Copyright 2014-2015 Friedemann Zenke
+*
+* This file is part of Auryn, a simulation package for plastic
+* spiking neural networks.
+* 
+* Auryn is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Auryn is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Auryn.  If not, see <http://www.gnu.org/licenses/>.
+*
+* If you are using Auryn or parts of it for your work please cite:
+* Zenke, F. and Gerstner, W., 2014. Limits to high-speed simulations 
+* of spiking neural networks using general-purpose computers. 
+* Front Neuroinform 8, 76. doi: 10.3389/fninf.2014.00076
+*/
+
+#ifndef QUANTIZEDCONNECTION_H_
+#define QUANTIZEDCONNECTION_H_
+
+#include "auryn_definitions.h"
+#include "SparseConnection.h"
+
+using namespace std;
+
+/*! \brief A static SparseConnection which stores its weights with reduced precision
+ *
+ * The connection is built or loaded like a SparseConnection. Each time the 
+ * matrix is finalized (by the constructors and by load_from_file, 
+ * load_from_complete_file and load_from_binary_file) the weights are converted 
+ * to the number format given by QuantizationType and the single precision 
+ * weights are freed. The weights are converted back to single precision during
+ * spike propagation. With 16 bit weights each synapse takes 6 instead of 8 
+ * bytes and with 8 bit weights 5 bytes.
+ *
+ * The quantization error of the last conversion is reported by stats. Since 
+ * the weights are not stored as AurynWeight, get_ptr returns NULL and the 
+ * connection cannot be used with monitors which access weights through 
+ * pointers such as the WeightMonitor. The connection is not meant to be plastic.
+ */
+class QuantizedConnection : public SparseConnection
+{
+private:
+	QuantizationType quantization;
+	/*! Weights for QUANT_FP16 and QUANT_BF16 */
+	ComplexMatrix<unsigned short> * qw16;
+	/*! Weights for QUANT_INT8 */
+	ComplexMatrix<signed char> * qw8;
+	/*! Scale factors of the rows for QUANT_INT8 */
+	vector<AurynFloat> row_scales;
+	/*! Root mean square and maximum of the absolute quantization error */
+	AurynFloat rms_error, max_error;
+
+	void init(QuantizationType q);
+	void free_quantized();
+
+	/*! Returns an empty matrix with the same rows and column indices as w. */
+	template <typename Q> ComplexMatrix<Q> * copy_structure();
+	/*! Returns the row which contains the element with data index k. */
+	NeuronID row_of(AurynLong k);
+	/*! Returns the weight of the element with data index k in row i. */
+	AurynWeight get_value(NeuronID i, AurynLong k);
+	/*! Sets the weight of the element with data index k in row i. */
+	void set_value(NeuronID i, AurynLong k, AurynWeight value);
+
+protected:
+	void virtual_serialize(boost::archive::binary_oarchive & ar, const unsigned int version ) 
+	{
+		Connection::virtual_serialize(ar,version);
+		if ( quantization == QUANT_INT8 ) 
+			ar & *qw8 & row_scales;
+		else
+			ar & *qw16;
+	}
+
+	void virtual_serialize(boost::archive::binary_iarchive & ar, const unsigned int version ) 
+	{
+		Connection::virtual_serialize(ar,version);
+		if ( quantization == QUANT_INT8 ) 
+			ar & *qw8 & row_scales;
+		else
+			ar & *qw16;
+	}
+
+public:
+	QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+			QuantizationType quantization=QUANT_FP16, TransmitterType transmitter=GLUT);
+	QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+			const char * filename, 
+			QuantizationType quantization=QUANT_FP16, TransmitterType transmitter=GLUT);
+	QuantizedConnection(SpikingGroup * source, NeuronGroup * destination, 
+			AurynWeight weight, AurynFloat sparseness=0.05, 
+			QuantizationType quantization=QUANT_FP16, TransmitterType transmitter=GLUT, 
+			string name="QuantizedConnection");
+	virtual ~QuantizedConnection();
+
+	/*! Converts the single precision weights in w to the quantized format and 
+	 * frees them. Is called by finalize. */
+	void quantize();
+	/*! Returns a new single precision matrix with the current weights. 
+	 * The caller has to delete it. */
+	ForwardMatrix * dequantize();
+	QuantizationType get_quantization();
+
+	virtual AurynWeight get(NeuronID i, NeuronID j);
+	/*! Returns NULL since weights are not stored as AurynWeight. */
+	virtual AurynWeight * get_ptr(NeuronID i, NeuronID j);
+	virtual AurynWeight get_data(NeuronID i);
+	virtual void set_data(NeuronID i, AurynWeight value);
+	virtual void set(NeuronID i, NeuronID j, AurynWeight value);
+	virtual void set(vector<neuron_pair> element_list, AurynWeight value);
+	virtual void set_all(AurynWeight weight);
+	virtual void scale_all(AurynFloat value);
+	virtual void clip(AurynWeight lo, AurynWeight hi);
+	virtual AurynLong get_nonzero();
+
+	/*! Finalizes w like SparseConnection::finalize and quantizes it. */
+	virtual void finalize();
+	virtual void propagate();
+	virtual void permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids);
+
+	virtual AurynDouble sum();
+	virtual void stats(AurynFloat &mean, AurynFloat &std);
+	/*! Computes mean and standard deviation of the weights and returns the 
+	 * root mean square and maximum of the absolute error made when the 
+	 * weights were last quantized. */
+	void stats(AurynFloat &mean, AurynFloat &std, AurynFloat &rms_error, AurynFloat &max_error);
+
+	virtual bool write_to_file(string filename);
+	virtual bool write_to_binary_file(string filename);
+
+	vector<neuron_pair> get_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_col, NeuronID hi_col);
+
+	/*! Converts a float to IEEE half precision with rounding to nearest even */
+	static inline unsigned short float_to_half(AurynFloat value);
+	/*! Converts an IEEE half precision number to float */
+	static inline AurynFloat half_to_float(unsigned short value);
+	/*! Converts a float to bfloat16 with rounding to nearest even */
+	static inline unsigned short float_to_bfloat16(AurynFloat value);
+	/*! Converts a bfloat16 number to float */
+	static inline AurynFloat bfloat16_to_float(unsigned short value);
+};
+
+union quantized_connection_float_bits {
+	AurynFloat f;
+	unsigned int u;
+};
+
+inline unsigned short QuantizedConnection::float_to_half(AurynFloat value)
+{
+#ifdef __F16C__
+	return _cvtss_sh(value, 0);
+#else
+	// adapted from F. Giesen's float_to_half_fast3_rtne
+	quantized_connection_float_bits f;
+	f.f = value;
+	const unsigned int sign = f.u & 0x80000000u;
+	f.u ^= sign;
+	unsigned short o;
+	if ( f.u >= (143u << 23) ) { // Inf or NaN
+		o = ( f.u > (255u << 23) ) ? 0x7e00 : 0x7c00;
+	} else if ( f.u < (113u << 23) ) { // subnormal or zero
+		quantized_connection_float_bits magic;
+		magic.u = 126u << 23;
+		f.f += magic.f;
+		o = f.u - magic.u;
+	} else {
+		const unsigned int mant_odd = (f.u >> 13) & 1;
+		f.u -= 112u << 23; // rebias exponent
+		f.u += 0xfff + mant_odd;
+		o = f.u >> 13;
+	}
+	return o | (sign >> 16);
+#endif /* __F16C__ */
+}
+
+inline AurynFloat QuantizedConnection::half_to_float(unsigned short value)
+{
+#ifdef __F16C__
+	return _cvtsh_ss(value);
+#else
+	const unsigned int shifted_exp = 0x7c00u << 13;
+	quantized_connection_float_bits o;
+	o.u = (value & 0x7fffu) << 13;
+	const unsigned int exp = shifted_exp & o.u;
+	o.u += 112u << 23;
+	if ( exp == shifted_exp ) { // Inf or NaN
+		o.u += 112u << 23;
+	} else if ( exp == 0 ) { // zero or subnormal
+		quantized_connection_float_bits magic;
+		magic.u = 113u << 23;
+		o.u += 1u << 23;
+		o.f -= magic.f;
+	}
+	o.u |= (value & 0x8000u) << 16;
+	return o.f;
+#endif /* __F16C__ */
+}
+
+inline unsigned short QuantizedConnection::float_to_bfloat16(AurynFloat value)
+{
+	quantized_connection_float_bits f;
+	f.f = value;
+	if ( (f.u & 0x7fffffffu) > 0x7f800000u ) // NaN
+		return (f.u >> 16) | 0x40;
+	f.u += 0x7fff + ((f.u >> 16) & 1);
+	return f.u >> 16;
+}
+
+inline AurynFloat QuantizedConnection::bfloat16_to_float(unsigned short value)
+{
+	quantized_connection_float_bits f;
+	f.u = ((unsigned int) value) << 16;
+	return f.f;
+}
+
+#endif /*QUANTIZEDCONNECTION_H_*/
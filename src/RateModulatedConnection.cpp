@@ -88,9 +88,11 @@ void RateModulatedConnection::free()
 
 void RateModulatedConnection::propagate_forward()
 {
-	for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ; // spike = pre_spike
-			spike != src->get_spikes()->end() ; ++spike ) {
-		for (NeuronID * c = w->get_row_begin(*spike) ; c != w->get_row_end(*spike) ; ++c ) { // c = post index
+	const SpikeContainer * spikes = src->get_spikes();
+	for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) {
+		const NeuronID spike = (*spikes)[k]; // spike = pre_spike
+		prefetch_spike_row(spikes, k);
+		for (NeuronID * c = w->get_row_begin(spike) ; c != w->get_row_end(spike) ; ++c ) { // c = post index
 			NeuronID * ind = w->get_ind_begin(); // first element of index array
 			AurynWeight * data = w->get_data_begin();
 			AurynWeight value = data[c-ind]; 
@@ -117,6 +119,11 @@ void RateModulatedConnection::evolve()
 	if ( rate_modulation_mul > 10 ) rate_modulation_mul = 10;
 }
 
+bool RateModulatedConnection::allows_temporal_blocking()
+{
+	return false;
+}
+
 RateModulatedConnection::~RateModulatedConnection()
 {
 	if ( dst->get_post_size() > 0 ) 
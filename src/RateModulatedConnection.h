@@ -37,8 +37,6 @@
 
 using namespace std;
 
-typedef SimpleMatrix<AurynWeight*> BackwardMatrix;
-
 //! \brief Rate Modulated Connection implements a SparseConnection in which the weights depend
 //  	   on the averaged rate of a given SpikingGropu (rate_modulating_group).
 //  
@@ -100,6 +98,8 @@ public:
 	void propagate_forward();
 	void propagate();
 	void evolve();
+	/*! The modulation depends on the rate of another group. */
+	virtual bool allows_temporal_blocking();
 	void set_modulating_group(SpikingGroup * group);
 
 	virtual bool load_from_file(string filename);
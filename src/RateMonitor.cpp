@@ -58,8 +58,9 @@ void RateMonitor::propagate()
 	if ( src->evolve_locally() ) {
 		if (sys->get_clock()%ssize==0) {
 			outfile << dt*(sys->get_clock()) << " "; 
+			// columns are in the order of the original ids (see System::reorder_neurons)
 			for  (NeuronID i = 0 ; i < src->get_rank_size() ; ++i ) {
-				outfile << tr_post->normalized_get(i)
+				outfile << tr_post->normalized_get(src->global2rank(src->get_renumbered_id(src->rank2global(i))))
 					<< " "; 
 			}
 			outfile << "\n";
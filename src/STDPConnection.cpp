@@ -36,6 +36,7 @@ void STDPConnection::init(AurynFloat eta, AurynFloat maxweight)
 
 	tr_pre  = src->get_pre_trace(tau_pre);
 	tr_post = dst->get_post_trace(tau_post);
+	lazy_pre_trace = tr_pre;
 
 	set_min_weight(0.0);
 	set_max_weight(maxweight);
@@ -120,6 +121,8 @@ void STDPConnection::propagate_forward()
 
 			// transmit signal to target at postsynaptic neuron
 			AurynWeight * weight = w->get_data_ptr(c); 
+			if ( lazy_updates ) 
+				apply_pending_post_spikes(*spike, dst->global2rank(*c), weight);
 			transmit( *c , *weight );
 
 			// handle plasticity
@@ -132,11 +135,20 @@ void STDPConnection::propagate_forward()
 					*weight = get_min_weight();
 			}
 		}
+		if ( lazy_updates ) update_pending_row(*spike);
 	}
 }
 
 void STDPConnection::propagate_backward()
 {
+	if (stdp_active && lazy_updates) { 
+		for (SpikeContainer::const_iterator spike = dst->get_spikes_immediate()->begin() ; // spike = post_spike
+				spike != dst->get_spikes_immediate()->end() ; 
+				++spike ) 
+			add_pending_post_spike(dst->global2rank(*spike), B);
+		return;
+	}
+
 	if (stdp_active) { 
 		SpikeContainer::const_iterator spikes_end = dst->get_spikes_immediate()->end();
 		// loop over all spikes
@@ -144,21 +156,8 @@ void STDPConnection::propagate_backward()
 				spike != spikes_end ; 
 				++spike ) {
 
-			// loop over all presynaptic partners
-			for (const NeuronID * c = bkw->get_row_begin(*spike) ; c != bkw->get_row_end(*spike) ; ++c ) {
-
-				#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
-				// prefetches next memory cells to reduce number of last-level cache misses
-				_mm_prefetch((const char *)bkw->get_data(c)+2,  _MM_HINT_NTA);
-				#endif
-
-				// computes plasticity update
-				AurynWeight * weight = bkw->get_data(c); 
-				*weight += dw_post(*c);
-
-				// clips too large weights
-				if (*weight>get_max_weight()) *weight=get_max_weight();
-			}
+			// dw_post of all presynaptic partners, clipped at the maximum weight
+			add_to_bkw_row(*spike, tr_pre, B);
 		}
 	}
 }
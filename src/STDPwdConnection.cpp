@@ -156,10 +156,10 @@ void STDPwdConnection::propagate_backward()
 			for (NeuronID * c = bkw->get_row_begin(*spike) ; c != bkw->get_row_end(*spike) ; ++c ) {
 
 				#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
-				_mm_prefetch((const char *)bkw_data[c-bkw_ind+1],  _MM_HINT_NTA);
+				_mm_prefetch((const char *)(fwd_data+bkw_data[c-bkw_ind+1]),  _MM_HINT_NTA);
 				#endif
 
-				AurynWeight * value = bkw_data[c-bkw_ind]; // create a shortcut for readability
+				AurynWeight * value = fwd_data+bkw_data[c-bkw_ind]; // create a shortcut for readability
 			    AurynWeight fplus = pow((get_max_weight()-*value),param_mu_plus); // compute f_minus(w) function value
 			    *value += fudge_pot*fplus*tr_pre->get(*c); // update the weight
 			}
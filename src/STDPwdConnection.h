@@ -67,7 +67,7 @@ protected:
 	AurynWeight * fwd_data;
 
 	NeuronID * bkw_ind; 
-	AurynWeight ** bkw_data;
+	AurynInt * bkw_data;
 
 	PRE_TRACE_MODEL * tr_pre;
 	DEFAULT_TRACE_MODEL * tr_post;
@@ -33,9 +33,10 @@ void STPConnection::init()
 		tau_f = 1.0;
 		Urest = 0.3;
 		Ujump = 0.01;
+		init_decay();
 		state_x = auryn_vector_float_alloc( src->get_rank_size() );
 		state_u = auryn_vector_float_alloc( src->get_rank_size() );
-		state_temp = auryn_vector_float_alloc( src->get_rank_size() );
+		state_time.assign( src->get_rank_size(), sys->get_clock() );
 		for (NeuronID i = 0; i < src->get_rank_size() ; i++)
 		{
 			   auryn_vector_float_set (state_x, i, 1 ); // TODO
@@ -95,7 +96,6 @@ void STPConnection::free()
 	if ( src->get_rank_size() > 0 ) {
 		auryn_vector_float_free (state_x);
 		auryn_vector_float_free (state_u);
-		auryn_vector_float_free (state_temp);
 	}
 }
 
@@ -107,6 +107,27 @@ STPConnection::~STPConnection()
 		free();
 }
 
+void STPConnection::init_decay()
+{
+	// the closed form of the Euler steps x += dt/tau_d*(1-x) 
+	// and u += dt/tau_f*(Ujump-u) used before
+	log_decay_x = log(1.0-dt/tau_d);
+	log_decay_u = log(1.0-dt/tau_f);
+}
+
+void STPConnection::update_state(NeuronID i)
+{
+	const AurynTime now = sys->get_clock();
+	if ( state_time[i] == now ) return;
+
+	const double steps = now-state_time[i];
+	const double x = auryn_vector_float_get( state_x, i );
+	const double u = auryn_vector_float_get( state_u, i );
+	auryn_vector_float_set( state_x, i, 1-(1-x)*exp(steps*log_decay_x) );
+	auryn_vector_float_set( state_u, i, Ujump+(u-Ujump)*exp(steps*log_decay_u) );
+	state_time[i] = now;
+}
+
 void STPConnection::push_attributes()
 {
 	SpikeContainer * spikes = src->get_spikes_immediate();
@@ -114,6 +135,7 @@ void STPConnection::push_attributes()
 			spike != spikes->end() ; ++spike ) {
 		// dynamics 
 		NeuronID spk = src->global2rank(*spike);
+		update_state(spk);
 		double x = auryn_vector_float_get( state_x, spk );
 		double u = auryn_vector_float_get( state_u, spk );
 		auryn_vector_float_set( state_x, spk, x-u*x );
@@ -124,21 +146,9 @@ void STPConnection::push_attributes()
 	}
 }
 
-void STPConnection::evolve()
+bool STPConnection::allows_temporal_blocking()
 {
-	// dynamics of x
-	auryn_vector_float_set_all( state_temp, 1);
-	auryn_vector_float_saxpy(-1,state_x,state_temp);
-	auryn_vector_float_saxpy(dt/tau_d,state_temp,state_x);
-
-	// dynamics of u
-	auryn_vector_float_set_all( state_temp, Ujump);
-	auryn_vector_float_saxpy(-1,state_u,state_temp);
-	auryn_vector_float_saxpy(dt/tau_f,state_temp,state_u);
-
-	// double x = auryn_vector_float_get( state_x, 0 );
-	// double u = auryn_vector_float_get( state_u, 0 );
-	// cout << setprecision(5) << x << " " << u << " " << x*u << endl;
+	return false;
 }
 
 void STPConnection::propagate()
@@ -153,10 +163,11 @@ void STPConnection::propagate()
 			NeuronID * ind = w->get_row_begin(0); // first element of index array
 			AurynWeight * data = w->get_data_begin();
 			AttributeContainer::const_iterator attr = src->get_attributes()->begin();
-			SpikeContainer::const_iterator spikes_end = src->get_spikes()->end();
-			for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
-					spike != spikes_end ; ++spike ) {
-				for (NeuronID * c = w->get_row_begin(*spike) ; c != w->get_row_end(*spike) ; ++c ) {
+			const SpikeContainer * spikes = src->get_spikes();
+			for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) {
+				const NeuronID spike = (*spikes)[k];
+				prefetch_spike_row(spikes, k);
+				for (NeuronID * c = w->get_row_begin(spike) ; c != w->get_row_end(spike) ; ++c ) {
 					AurynWeight value = data[c-ind] * *attr; 
 					transmit( *c , value );
 				}
@@ -166,15 +177,26 @@ void STPConnection::propagate()
 	}
 }
 
+void STPConnection::update_all_states()
+{
+	for ( NeuronID i = 0 ; i < state_time.size() ; ++i ) 
+		update_state(i);
+}
+
 void STPConnection::set_tau_f(AurynFloat tauf) {
+	update_all_states();
 	tau_f = tauf;
+	init_decay();
 }
 
 void STPConnection::set_tau_d(AurynFloat taud) {
+	update_all_states();
 	tau_d = taud;
+	init_decay();
 }
 
 void STPConnection::set_ujump(AurynFloat r) {
+	update_all_states();
 	Ujump = r;
 }
 
@@ -50,17 +50,35 @@ private:
 	// STP parameters (maybe this should all move to a container)
 	auryn_vector_float * state_x;
 	auryn_vector_float * state_u;
-	auryn_vector_float * state_temp;
+	/*! Time step up to which state_x and state_u of each presynaptic neuron 
+	 * have been relaxed. They are only brought up to date when the neuron 
+	 * spikes (see push_attributes). */
+	vector<AurynTime> state_time;
 
 	double tau_d;
 	double tau_f;
 	double Urest;
 	double Ujump;
 
+	/*! Logarithms of the per step relaxation factors of x and u. */
+	double log_decay_x;
+	double log_decay_u;
+
 
 	void init();
 	void free();
 
+	/*! Computes log_decay_x and log_decay_u from tau_d and tau_f. */
+	void init_decay();
+
+	/*! Relaxes x and u of the rank local presynaptic neuron i up to the 
+	 * current time step. */
+	void update_state(NeuronID i);
+
+	/*! Relaxes x and u of all presynaptic neurons up to the current time step
+	 * before the parameters of the relaxation change. */
+	void update_all_states();
+
 public:
 
 	/*! Minimal constructor for from file init -- deprecated
@@ -118,11 +136,14 @@ public:
 	/*! Implements the connections propagate function (auryn internal use). */
 	virtual void propagate();
 
-	/*! Internal function to push spike attributes. */
+	/*! Internal function to push spike attributes. Relaxes x and u of each 
+	 * spiking neuron in closed form since its last spike before the spike 
+	 * triggered update, which makes the cost of STP proportional to the number 
+	 * of presynaptic spikes instead of the number of presynaptic neurons. */
 	void push_attributes();
 
-	/*! Implements the connections evolve function (auryn internal use). */
-	void evolve();
+	/*! STPConnection pushes spike attributes into its source. */
+	virtual bool allows_temporal_blocking();
 
 };
 
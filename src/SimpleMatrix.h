@@ -142,6 +142,14 @@ public:
 	/*! Gets the matching data value for a given index pointer */
 	T get_data(const NeuronID * ind_ptr);
 	void fill_zeros();
+	/*! Lays out the rows of a cleared matrix such that row i holds sizes[i] 
+	 * elements and marks the matrix as filled. The column indices and values
+	 * then have to be written by the caller through get_ind_begin() and 
+	 * get_data_begin() in ascending column order within each row. This allows
+	 * to build a matrix out of row order, e.g. when transposing.
+	 * \param sizes Array with the number of elements of each of the m_rows rows
+	 * \throw AurynMatrixBufferException */
+	void set_row_sizes(const AurynLong * sizes);
 	AurynDouble get_fill_level();
 	T get(NeuronID i, NeuronID j);
 	bool exists(NeuronID i, NeuronID j);
@@ -394,6 +402,22 @@ void SimpleMatrix<T>::fill_zeros()
 }
 
 
+template <typename T>
+void SimpleMatrix<T>::set_row_sizes(const AurynLong * sizes)
+{
+	AurynLong total = 0;
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) 
+		total += sizes[i];
+	if ( total > datasize ) throw AurynMatrixBufferException();
+
+	rowptrs[0] = colinds;
+	for ( NeuronID i = 0 ; i < m_rows ; ++i ) 
+		rowptrs[i+1] = rowptrs[i]+sizes[i];
+	n_nonzero = total;
+	current_row = get_m_rows();
+	current_col = 0;
+}
+
 template <typename T>
 T SimpleMatrix<T>::get(NeuronID i, NeuronID j)
 {
@@ -28,6 +28,29 @@
 // static members
 boost::mt19937 SparseConnection::sparse_connection_gen = boost::mt19937();
 bool SparseConnection::has_been_seeded = false;
+bool SparseConnection::parallel_fill = false;
+unsigned int SparseConnection::prefetch_rows_ahead = DEFAULT_PREFETCH_ROWS_AHEAD;
+unsigned int SparseConnection::prefetch_targets_ahead = DEFAULT_PREFETCH_TARGETS_AHEAD;
+
+/*! Draws the synapses of row i for connect_block_random_parallel. Writes the
+ * column indices to ind unless it is NULL and returns the number of synapses. */
+static AurynLong random_fill_row(AurynLong seed, NeuronID i, 
+		NeuronID lo_col, NeuronID r, NeuronID s, AurynLong jdim, 
+		AurynDouble log_q, bool dense, bool skip_diag, NeuronID * ind)
+{
+	CounterRandomStream stream(seed,i);
+	AurynLong count = 0;
+	AurynLong x = dense ? 0 : stream.geometric(log_q,jdim);
+	while ( x < jdim ) {
+		const NeuronID j = lo_col + s*x + r;
+		if ( !skip_diag || i!=j ) {
+			if ( ind ) ind[count] = j;
+			++count;
+		}
+		x += dense ? 1 : 1+stream.geometric(log_q,jdim);
+	}
+	return count;
+}
 
 
 SparseConnection::SparseConnection(const char * filename) : Connection()
@@ -141,6 +164,8 @@ void SparseConnection::init()
 
 	patterns_every_pre = 1;
 	patterns_every_post = 1;
+
+	tile_size = 0;
 }
 
 void SparseConnection::seed(NeuronID randomseed) 
@@ -224,6 +249,7 @@ void SparseConnection::random_data(AurynWeight mean, AurynWeight sigma)
 
 void SparseConnection::sparse_set_data(AurynDouble sparseness, AurynWeight value) 
 {
+	apply_pending_updates();
 	stringstream oss;
 	oss << "SparseConnection: (" << get_name() << "): setting data sparsely with sparseness=" << sparseness << " value=" << value ;
 	logger->msg(oss.str(),DEBUG);
@@ -266,18 +292,20 @@ void SparseConnection::set_block(NeuronID lo_row, NeuronID hi_row, NeuronID lo_c
 		for ( NeuronID * j = w->get_row_begin(i) ; j != w->get_row_end(i) ; ++j )
 		{
 			if (i >= lo_row && i < hi_row && *j >= lo_col && *j < hi_col )
-			  w->get_data_begin()[j-w->get_row_begin(0)] = temp;
+			  w->set_data(j-w->get_row_begin(0), temp);
 		}
 	}
 }
 
 void SparseConnection::set_all(AurynWeight weight)
 {
+	apply_pending_updates();
 	w->set_all( weight );
 }
 
 void SparseConnection::scale_all(AurynFloat value)
 {
+	apply_pending_updates();
 	w->scale_all( value );
 }
 
@@ -290,7 +318,7 @@ void SparseConnection::set_upper_triangular(AurynWeight weight)
 		for ( NeuronID * j = w->get_row_begin(i) ; j != w->get_row_end(i) ; ++j )
 		{
 			if ( i <=  *j )
-			  w->get_data_begin()[j-w->get_row_begin(0)] = temp;
+			  w->set_data(j-w->get_row_begin(0), temp);
 		}
 	}
 }
@@ -303,6 +331,11 @@ void SparseConnection::connect_block_random(AurynWeight weight, float sparseness
 		NeuronID hi_col, 
 		bool skip_diag )
 {
+	if ( parallel_fill ) {
+		connect_block_random_parallel(weight,sparseness,lo_row,hi_row,lo_col,hi_col,skip_diag);
+		return;
+	}
+
 	int r = 0; // these variables are used to speed up building the matrix if the destination is distributed
 	int s = 1;
 
@@ -389,6 +422,98 @@ void SparseConnection::connect_block_random(AurynWeight weight, float sparseness
 	logger->msg(oss.str(),DEBUG);
 }
 
+void SparseConnection::connect_block_random_parallel(AurynWeight weight, float sparseness,
+		NeuronID lo_row, 
+		NeuronID hi_row, 
+		NeuronID lo_col, 
+		NeuronID hi_col, 
+		bool skip_diag )
+{
+	if (!has_been_allocated)
+		throw AurynConnectionAllocationException();
+
+	const NeuronID r = communicator->rank()-dst->get_locked_rank(); 
+	const NeuronID s = dst->get_locked_range();
+
+	const NeuronID idim = (hi_row>lo_row) ? hi_row-lo_row : 0;
+	AurynLong jdim = (hi_col-lo_col)/s;
+	if ( (hi_col-lo_col)%s > r ) { // some ranks have one more "carry" neuron
+		jdim += 1;
+	}
+	if ( sparseness <= 0.0 ) jdim = 0;
+
+	// Each call draws a new seed such that the streams of subsequent calls 
+	// differ. Each row i then uses the stream (seed,i) to draw its synapses.
+	AurynLong seed = SparseConnection::sparse_connection_gen();
+	seed = (seed<<32) ^ SparseConnection::sparse_connection_gen();
+	const bool dense = sparseness >= 1.0;
+	const AurynDouble log_q = dense ? 0.0 : std::log(1.0-sparseness);
+
+	int nthreads = 1;
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	nthreads = std::max(1,std::min(sys->get_num_threads(),(int)idim));
+#endif /* CODE_ACTIVATE_OPENMP_THREADS */
+
+	// Since the streams are counter-based, the rows can be drawn twice: 
+	// first to count the synapses per row and then to write them directly
+	// into their place in the matrix.
+	vector<AurynLong> sizes(idim,0);
+	#pragma omp parallel for schedule(static) num_threads(nthreads) if(nthreads>1)
+	for ( NeuronID k = 0 ; k < idim ; ++k ) 
+		sizes[k] = random_fill_row(seed,lo_row+k,lo_col,r,s,jdim,log_q,dense,skip_diag,NULL);
+
+	AurynLong count = 0;
+	for ( NeuronID k = 0 ; k < idim ; ++k ) 
+		count += sizes[k];
+
+	if ( w->get_nonzero()+count > w->get_datasize() ) {
+		stringstream oss;
+		oss << "SparseConnection: ("<< get_name() 
+			<< "): Growing buffer to hold " << count << " new elements.";
+		logger->msg(oss.str(),NOTIFICATION);
+		w->resize_buffer(w->get_nonzero()+count);
+	}
+
+	try {
+		if ( idim ) w->append_row_sizes(lo_row,hi_row,&sizes[0]);
+	}
+	catch ( AurynMatrixDimensionalityException )
+	{
+		stringstream oss;
+		oss << "SparseConnection: ("<< get_name() 
+			<<"): Trying to add rows outside of matrix (lo_row=" << lo_row 
+			<< ", hi_row=" << hi_row << ")";
+		logger->msg(oss.str(),ERROR);
+		return;
+	} 
+	catch ( AurynMatrixPushBackException )
+	{
+		stringstream oss;
+		oss << "SparseConnection: ("<< get_name() 
+			<< "): Failed appending rows. Rows [" << lo_row << ", " << hi_row 
+			<< ") overlap with rows filled before.";
+		logger->msg(oss.str(),ERROR);
+		return;
+	} 
+
+	if ( w->is_uniform() && w->get_uniform_value() != weight ) 
+		w->expand_uniform();
+
+	#pragma omp parallel for schedule(static) num_threads(nthreads) if(nthreads>1)
+	for ( NeuronID k = 0 ; k < idim ; ++k ) {
+		random_fill_row(seed,lo_row+k,lo_col,r,s,jdim,log_q,dense,skip_diag,w->get_row_begin(lo_row+k));
+		w->set_row(lo_row+k, weight);
+	}
+
+	stringstream oss;
+	oss << "SparseConnection: ("<< get_name() <<"): Finished connect_block_random_parallel ["
+		<< lo_row << ", " << hi_row << ", " << lo_col << ", " << hi_col <<  "] " 
+		<< "with " << nthreads << " threads and pushed " 
+		<< std::scientific << setprecision(4) << (double) count <<  " entries. " 
+		<< "Resulting overall sparseness " << 1.*get_nonzero()/src->get_pre_size()/dst->get_post_size();
+	logger->msg(oss.str(),DEBUG);
+}
+
 void SparseConnection::connect_random(AurynWeight weight, float sparseness, bool skip_diag)
 {
 	if ( dst->evolve_locally() ) { // if there are no local units there is no need for synapses
@@ -414,6 +539,12 @@ void SparseConnection::finalize()
 			oss2 << "SparseConnection: ("<< get_name() <<"): Wasteful fill level (" << w->get_fill_level() << ")! Make sure everything is in order!";
 			logger->msg(oss2.str(),WARNING);
 		}
+		if ( w->compress_uniform() ) {
+			stringstream oss3;
+			oss3 << "SparseConnection: ("<< get_name() <<"): All weights are " 
+				<< w->get_uniform_value() << ". Only storing column indices.";
+			logger->msg(oss3.str(),DEBUG);
+		}
 	}
 }
 
@@ -426,17 +557,162 @@ bool SparseConnection::push_back(NeuronID i, NeuronID j, AurynWeight weight)
 	return false;
 }
 
+template <typename Index, typename Value>
+void SparseConnection::propagate_rows(const Index & index, const Value & value, AurynLong ahead)
+{
+	const SpikeContainer * spikes = src->get_spikes();
+	for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) {
+		prefetch_spike_row(spikes, k);
+		const AurynLong end = w->get_row_end_index((*spikes)[k]);
+		AurynLong c = w->get_row_begin_index((*spikes)[k]);
+		if ( ahead ) {
+			for ( ; c+ahead < end ; ++c ) {
+				prefetch_target(index(c+ahead));
+				target[index(c)] += value(c);
+			}
+		}
+		for ( ; c < end ; ++c ) 
+			target[index(c)] += value(c);
+	}
+}
+
+template <typename Value>
+void SparseConnection::propagate_tiled(const Value & value)
+{
+	const SpikeContainer * spikes = src->get_spikes();
+	tile_cursors.resize(spikes->size());
+	for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) 
+		tile_cursors[k] = w->get_row_begin_index((*spikes)[k]);
+
+	const NeuronID range = dst->get_locked_range();
+#ifdef CODE_USE_LOCAL_COLUMN_INDICES
+	const unsigned short * local = w->get_local_index(range);
+#else
+	const unsigned short * local = NULL;
+#endif // CODE_USE_LOCAL_COLUMN_INDICES
+	const NeuronID * ind = w->get_ind_begin();
+
+	// Since the column indices of each row are sorted, the elements of a row
+	// which fall into a tile are contiguous and the cursors only move forward.
+	for ( NeuronID lo = 0 ; lo < dst->get_rank_size() ; lo += tile_size ) {
+		const AurynLong hi = (AurynLong)lo+tile_size;
+		const AurynLong hi_global = hi*range; // first global id behind the tile
+		for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) {
+			const AurynLong end = w->get_row_end_index((*spikes)[k]);
+			AurynLong c = tile_cursors[k];
+			if ( local != NULL ) {
+				for ( ; c < end && local[c] < hi ; ++c ) 
+					target[local[c]] += value(c);
+			} else {
+				for ( ; c < end && ind[c] < hi_global ; ++c ) 
+					transmit( ind[c] , value(c) );
+			}
+			tile_cursors[k] = c;
+		}
+	}
+}
+
 void SparseConnection::propagate()
 {
-	for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ;
-			spike != src->get_spikes()->end() ; 
-			++spike ) {
-		for ( AurynLong c = w->get_row_begin_index(*spike) ;
-				c < w->get_row_end_index(*spike) ;
-				++c ) {
-			transmit( w->get_colind(c) , w->get_value(c) );
+	if ( tile_size && dst->get_rank_size() > tile_size && src->get_spikes()->size() > 1 ) {
+		if ( w->is_uniform() ) {
+			UniformValue value;
+			value.value = w->get_uniform_value();
+			propagate_tiled(value);
+		} else {
+			MatrixValue value;
+			value.data = w->get_const_data_begin();
+			propagate_tiled(value);
 		}
+		return;
+	}
+
+#ifdef CODE_USE_LOCAL_COLUMN_INDICES
+	const unsigned short * local = w->get_local_index(dst->get_locked_range());
+	if ( local != NULL ) {
+		propagate_local(local);
+		return;
+	}
+#endif // CODE_USE_LOCAL_COLUMN_INDICES
+
+	GlobalTargetIndex index;
+	index.ind = w->get_ind_begin();
+	index.group = dst;
+	const AurynLong ahead = prefetch_targets_ahead;
+
+	if ( w->is_uniform() ) { // only column indices are stored
+		UniformValue value;
+		value.value = w->get_uniform_value();
+		propagate_rows(index, value, ahead);
+	} else {
+		MatrixValue value;
+		value.data = w->get_const_data_begin();
+		propagate_rows(index, value, ahead);
+	}
+}
+
+void SparseConnection::propagate_local(const unsigned short * local)
+{
+	LocalTargetIndex index;
+	index.local = local;
+
+	if ( w->is_uniform() ) { 
+		UniformValue value;
+		value.value = w->get_uniform_value();
+		propagate_rows(index, value, prefetch_targets_ahead);
+	} else {
+		MatrixValue value;
+		value.data = w->get_const_data_begin();
+		propagate_rows(index, value, prefetch_targets_ahead);
+	}
+}
+
+bool SparseConnection::allows_neuron_permutation()
+{
+	return true;
+}
+
+void SparseConnection::permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids)
+{
+	w->permute(pre_ids, post_ids);
+}
+
+void SparseConnection::renumber_matrix(ForwardMatrix * m, bool to_original)
+{
+	bool renumbered = false;
+	vector<NeuronID> row_ids(m->get_m_rows());
+	for ( NeuronID i = 0 ; i < m->get_m_rows() ; ++i ) {
+		row_ids[i] = i;
+		if ( i < src->get_size() ) 
+			row_ids[i] = to_original ? src->get_original_id(i) : src->get_renumbered_id(i);
+		if ( row_ids[i] != i ) renumbered = true;
 	}
+	vector<NeuronID> col_ids(m->get_n_cols());
+	for ( NeuronID j = 0 ; j < m->get_n_cols() ; ++j ) {
+		col_ids[j] = j;
+		if ( j < dst->get_size() ) 
+			col_ids[j] = to_original ? dst->get_original_id(j) : dst->get_renumbered_id(j);
+		if ( col_ids[j] != j ) renumbered = true;
+	}
+	if ( renumbered ) m->permute(&row_ids, &col_ids);
+}
+
+void SparseConnection::set_tile_size(NeuronID size)
+{
+	tile_size = size;
+	stringstream oss;
+	oss << "SparseConnection: ("<< get_name() <<"): Setting propagate tile size to " << tile_size;
+	logger->msg(oss.str(),DEBUG);
+}
+
+NeuronID SparseConnection::get_tile_size()
+{
+	return tile_size;
+}
+
+bool SparseConnection::allows_temporal_blocking()
+{
+	return true;
 }
 
 void SparseConnection::sanity_check()
@@ -446,13 +722,11 @@ void SparseConnection::sanity_check()
 	AurynFloat * sum = new AurynFloat[dst->get_size()];
 	for ( NeuronID i = 0 ; i < dst->get_size() ; ++i ) sum[i] = 0.0;
 
-	NeuronID * ind = w->get_ind_begin(); // first element of index array
-	AurynWeight * data = w->get_data_begin();
 	for ( NeuronID i = 0 ; i < src->get_size() ; ++i ) {
 		for (NeuronID * c = w->get_row_begin(i) ; 
 				c < w->get_row_end(i) ; 
 				++c ) {
-			AurynWeight value = data[c-ind]; 
+			AurynWeight value = w->get_value(c); 
 			sum[*c] += value;
 		}
 	}
@@ -496,7 +770,7 @@ void SparseConnection::sanity_check()
 		for (NeuronID * c = w->get_row_begin(i) ; 
 				c != w->get_row_end(i) ; 
 				++c ) {
-			AurynWeight value = data[c-ind]; 
+			AurynWeight value = w->get_value(c); 
 			sum_rows[i] += value;
 		}
 	}
@@ -522,6 +796,7 @@ void SparseConnection::sanity_check()
 
 void SparseConnection::stats(AurynFloat &mean, AurynFloat &std)
 {
+	apply_pending_updates();
 	NeuronID count = 0;
 	AurynFloat sum = 0;
 	AurynFloat sum2 = 0;
@@ -535,9 +810,10 @@ void SparseConnection::stats(AurynFloat &mean, AurynFloat &std)
 	// 		sum2 += (t*t);
 	// 	}
 	// }
-	for ( AurynWeight * iter = w->get_data_begin() ; iter != w->get_data_end() ; ++iter ) {
-		sum  += *iter;
-		sum2 += (*iter * *iter);
+	for ( AurynLong i = 0 ; i < w->get_nonzero() ; ++i ) {
+		const AurynWeight value = w->get_value(i);
+		sum  += value;
+		sum2 += (value * value);
 	}
 	count = w->get_nonzero();
 	if ( count <= 1 ) {
@@ -551,10 +827,11 @@ void SparseConnection::stats(AurynFloat &mean, AurynFloat &std)
 
 AurynDouble SparseConnection::sum()
 {
+	apply_pending_updates();
 	AurynFloat sum = 0;
 
-	for ( AurynWeight * iter = w->get_data_begin() ; iter != w->get_data_end() ; ++iter ) {
-		sum  += *iter;
+	for ( AurynLong i = 0 ; i < w->get_nonzero() ; ++i ) {
+		sum  += w->get_value(i);
 	}
 	
 	return sum;
@@ -562,26 +839,31 @@ AurynDouble SparseConnection::sum()
 
 AurynWeight SparseConnection::get_data(NeuronID i)
 {
+	apply_pending_updates();
 	return w->get_data(i);
 }
 
 void SparseConnection::set_data(NeuronID i, AurynWeight value)
 {
+	apply_pending_updates();
 	w->set_data(i,value);
 }
 
 AurynWeight SparseConnection::get(NeuronID i, NeuronID j)
 {
+	apply_pending_updates();
 	return w->get(i,j);
 }
 
 AurynWeight * SparseConnection::get_ptr(NeuronID i, NeuronID j)
 {
+	apply_pending_updates();
 	return w->get_ptr(i,j);
 }
 
 void SparseConnection::set(vector<neuron_pair> element_list, AurynWeight value)
 {
+	apply_pending_updates();
 	for (vector<neuron_pair>::iterator iter = element_list.begin() ; iter != element_list.end() ; ++iter)
 	{
 		w->set((*iter).i, (*iter).j,value);
@@ -590,6 +872,7 @@ void SparseConnection::set(vector<neuron_pair> element_list, AurynWeight value)
 
 void SparseConnection::set(NeuronID i, NeuronID j, AurynWeight value)
 {
+	apply_pending_updates();
 	value = max(value,get_min_weight());
 	w->set(i,j,value);
 }
@@ -614,14 +897,16 @@ bool SparseConnection::write_to_file(ForwardMatrix * m, string filename )
 		<< "%\n"
 		<< get_m_rows() << " " << get_n_cols() << " " << m->get_nonzero() << endl;
 
+	renumber_matrix(m, true);
 	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
 	{
 		outfile << setprecision(7);
 		for ( NeuronID * j = m->get_row_begin(i) ; j != m->get_row_end(i) ; ++j )
 		{
-			outfile << i+1 << " " << *j+1 << " " << scientific << m->get_data_begin()[j-m->get_row_begin(0)] << fixed << "\n";
+			outfile << i+1 << " " << *j+1 << " " << scientific << m->get_value(j) << fixed << "\n";
 		}
 	}
+	renumber_matrix(m, false);
 
 	outfile.close();
 	return true;
@@ -629,6 +914,7 @@ bool SparseConnection::write_to_file(ForwardMatrix * m, string filename )
 
 bool SparseConnection::write_to_file(string filename)
 {
+	apply_pending_updates();
 	return write_to_file(w,filename.c_str());
 }
 
@@ -815,6 +1101,7 @@ bool SparseConnection::load_from_file(ForwardMatrix * m, string filename, AurynL
 	}
 
 	m->fill_zeros();
+	renumber_matrix(m, false); // the file contains the original ids
 	// finalize(); // commented this line out because it only acts on w
 
 	return true;
@@ -822,6 +1109,7 @@ bool SparseConnection::load_from_file(ForwardMatrix * m, string filename, AurynL
 
 bool SparseConnection::load_from_complete_file(string filename)
 {
+	apply_pending_updates();
 	AurynLong datasize = dryrun_from_file(filename);
 	stringstream oss;
 	oss << "Loading from complete file. Element count: "
@@ -835,11 +1123,342 @@ bool SparseConnection::load_from_complete_file(string filename)
 
 bool SparseConnection::load_from_file(string filename)
 {
+	apply_pending_updates();
 	bool result = load_from_file(w,filename);
 	finalize();
 	return result;
 }
 
+/*! Header of the binary weight matrix file format. It is followed by 
+ * num_sections offsets (in bytes from the beginning of the file) and 
+ * num_sections element counts, both AurynLong, and the sections themselves. */
+struct auryn_binary_matrix_header {
+	char magic[8];
+	NeuronID version;
+	NeuronID m_rows;
+	NeuronID n_cols;
+	NeuronID z_values;
+	NeuronID num_sections;
+	NeuronID sizeof_weight;
+};
+
+static const char auryn_binary_matrix_magic[8] = { 'A', 'U', 'R', 'Y', 'N', 'C', 'S', 'R' };
+static const NeuronID auryn_binary_matrix_version = 1;
+
+/*! Sections are aligned to cache lines in the file. */
+static AurynLong binary_matrix_align(AurynLong pos) 
+{
+	return (pos+63)/64*64;
+}
+
+/*! Size in bytes of a section with rows rows, nnz elements and z states. */
+static AurynLong binary_matrix_section_size(NeuronID rows, AurynLong nnz, NeuronID z) 
+{
+	AurynLong size = (AurynLong)(rows+1)*sizeof(AurynLong);
+	size = binary_matrix_align(size+nnz*sizeof(NeuronID));
+	return size + (AurynLong)z*nnz*sizeof(AurynWeight);
+}
+
+/*! MPI_File_write_at takes an int count, so large buffers are written in chunks. */
+static void binary_matrix_write_at(MPI_File fh, AurynLong offset, const void * buf, AurynLong bytes)
+{
+	const AurynLong chunk = 1<<30;
+	const char * ptr = (const char *) buf;
+	while ( bytes ) {
+		const AurynLong n = std::min(bytes,chunk);
+		MPI_File_write_at(fh, offset, (void*)ptr, (int)n, MPI_BYTE, MPI_STATUS_IGNORE);
+		offset += n;
+		ptr += n;
+		bytes -= n;
+	}
+}
+
+bool SparseConnection::write_to_binary_file(ForwardMatrix * m, string filename)
+{
+	// the sections are ordered by the ranks of the destination group
+	const bool participating = dst->evolve_locally();
+	const NeuronID num_sections = dst->get_locked_range();
+	const NeuronID section = communicator->rank()-dst->get_locked_rank();
+	const NeuronID rows = m->get_m_rows();
+	const NeuronID z_values = m->get_z_values();
+
+	AurynLong local_nnz = 0;
+	if ( participating ) local_nnz = m->get_nonzero();
+	vector<AurynLong> all_nnz;
+	mpi::all_gather(*communicator, local_nnz, all_nnz);
+
+	// compute section table 
+	vector<AurynLong> offsets(num_sections);
+	vector<AurynLong> counts(num_sections);
+	AurynLong pos = binary_matrix_align(sizeof(auryn_binary_matrix_header)
+			+ 2*num_sections*sizeof(AurynLong));
+	for ( NeuronID s = 0 ; s < num_sections ; ++s ) {
+		counts[s] = all_nnz[dst->get_locked_rank()+s];
+		offsets[s] = pos;
+		pos = binary_matrix_align(pos+binary_matrix_section_size(rows,counts[s],z_values));
+	}
+
+	MPI_File fh;
+	if ( MPI_File_open(*communicator, (char*)filename.c_str(), 
+				MPI_MODE_CREATE|MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS ) {
+		stringstream oss;
+	    oss << "Can't open output file " << filename;
+		logger->msg(oss.str(),ERROR);
+		throw AurynOpenFileException();
+	}
+	MPI_File_set_size(fh, pos); // truncates existing files
+
+	stringstream oss;
+	oss << get_name() 
+		<< ": Writing binary matrix to file ("
+		<< get_m_rows()<<"x"<<get_n_cols()
+		<< ", " << num_sections << " sections)";
+	logger->msg(oss.str(),NOTIFICATION);
+
+	renumber_matrix(m, true);
+	if ( participating ) {
+		if ( section == 0 ) {
+			auryn_binary_matrix_header header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.magic, auryn_binary_matrix_magic, sizeof(header.magic));
+			header.version = auryn_binary_matrix_version;
+			header.m_rows = rows;
+			header.n_cols = m->get_n_cols();
+			header.z_values = z_values;
+			header.num_sections = num_sections;
+			header.sizeof_weight = sizeof(AurynWeight);
+			binary_matrix_write_at(fh, 0, &header, sizeof(header));
+			binary_matrix_write_at(fh, sizeof(header), &offsets[0], num_sections*sizeof(AurynLong));
+			binary_matrix_write_at(fh, sizeof(header)+num_sections*sizeof(AurynLong), 
+					&counts[0], num_sections*sizeof(AurynLong));
+		}
+
+		// row offsets relative to the first element of the section
+		NeuronID ** rowptrs = m->get_rowptrs();
+		vector<AurynLong> row_offsets(rows+1);
+		for ( NeuronID i = 0 ; i < rows+1 ; ++i ) 
+			row_offsets[i] = rowptrs[i]-rowptrs[0];
+
+		AurynLong p = offsets[section];
+		binary_matrix_write_at(fh, p, &row_offsets[0], row_offsets.size()*sizeof(AurynLong));
+		p += row_offsets.size()*sizeof(AurynLong);
+		binary_matrix_write_at(fh, p, m->get_ind_begin(), local_nnz*sizeof(NeuronID));
+		p = binary_matrix_align(p+local_nnz*sizeof(NeuronID));
+		for ( StateID z = 0 ; z < z_values ; ++z ) {
+			if ( m->is_uniform() ) { // do not expand the matrix for writing
+				vector<AurynWeight> values(local_nnz+1, m->get_uniform_value());
+				binary_matrix_write_at(fh, p, &values[0], local_nnz*sizeof(AurynWeight));
+			} else {
+				binary_matrix_write_at(fh, p, m->get_data_begin(z), local_nnz*sizeof(AurynWeight));
+			}
+			p += local_nnz*sizeof(AurynWeight);
+		}
+	}
+	renumber_matrix(m, false);
+
+	MPI_File_close(&fh);
+	return true;
+}
+
+bool SparseConnection::write_to_binary_file(string filename)
+{
+	apply_pending_updates();
+	return write_to_binary_file(w,filename);
+}
+
+/*! Element of a row gathered from different sections while repartitioning. */
+struct binary_matrix_element {
+	NeuronID col;
+	AurynLong pos;
+	NeuronID section;
+	bool operator<(const binary_matrix_element & other) const { return col < other.col; }
+};
+
+bool SparseConnection::load_from_binary_file(ForwardMatrix * m, string filename)
+{
+	if ( !dst->evolve_locally() ) return true;
+
+	int fd = open(filename.c_str(), O_RDONLY);
+	struct stat st;
+	if ( fd < 0 || fstat(fd, &st) != 0 ) {
+		if ( fd >= 0 ) close(fd);
+		stringstream oss;
+		oss << "Can't open input file " << filename;
+		logger->msg(oss.str(),ERROR);
+		throw AurynOpenFileException();
+	}
+
+	const AurynLong filesize = st.st_size;
+	void * map = MAP_FAILED;
+	if ( filesize >= sizeof(auryn_binary_matrix_header) )
+		map = mmap(NULL, filesize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if ( map == MAP_FAILED ) {
+		stringstream oss;
+		oss << "Can't map input file " << filename;
+		logger->msg(oss.str(),ERROR);
+		throw AurynOpenFileException();
+	}
+	const char * base = (const char *) map;
+
+	auryn_binary_matrix_header header;
+	memcpy(&header, base, sizeof(header));
+	const AurynLong table_end = sizeof(header)+2*(AurynLong)header.num_sections*sizeof(AurynLong);
+	if ( memcmp(header.magic, auryn_binary_matrix_magic, sizeof(header.magic)) != 0 
+			|| header.version != auryn_binary_matrix_version 
+			|| header.sizeof_weight != sizeof(AurynWeight) 
+			|| table_end > filesize ) {
+		munmap(map, filesize);
+		stringstream oss;
+		oss << "Input format not recognized.";
+		logger->msg(oss.str(),ERROR);
+		return false;
+	}
+
+	if ( header.m_rows != m->get_m_rows() || header.n_cols != m->get_n_cols() ) {
+		munmap(map, filesize);
+		stringstream oss;
+		oss << get_name() << ": Matrix dimensions in " << filename 
+			<< " (" << header.m_rows << "x" << header.n_cols << ")"
+			<< " do not match the connection.";
+		logger->msg(oss.str(),ERROR);
+		return false;
+	}
+
+	const NeuronID rows = header.m_rows;
+	const AurynLong * offsets = (const AurynLong *)(base+sizeof(header));
+	const AurynLong * counts = offsets+header.num_sections;
+	for ( NeuronID s = 0 ; s < header.num_sections ; ++s ) {
+		if ( offsets[s]+binary_matrix_section_size(rows,counts[s],header.z_values) > filesize ) {
+			munmap(map, filesize);
+			stringstream oss;
+			oss << get_name() << ": Binary file " << filename << " is truncated.";
+			logger->msg(oss.str(),ERROR);
+			return false;
+		}
+	}
+
+	StateID z_values = header.z_values;
+	if ( z_values != m->get_z_values() ) {
+		stringstream oss;
+		oss << get_name() << ": File contains " << header.z_values 
+			<< " synaptic states, but the matrix has " << m->get_z_values() << ".";
+		logger->msg(oss.str(),WARNING);
+		z_values = std::min(z_values,(StateID)m->get_z_values());
+	}
+
+	// sections are selected by the rank within the destination group 
+	const bool same_partition = ( header.num_sections == dst->get_locked_range() );
+	const NeuronID section = communicator->rank()-dst->get_locked_rank();
+
+	AurynLong nnz = 0;
+	vector<AurynLong> row_sizes(rows,0);
+	vector<char> local_col;
+	if ( same_partition ) {
+		nnz = counts[section];
+		const AurynLong * row_offsets = (const AurynLong *)(base+offsets[section]);
+		for ( NeuronID i = 0 ; i < rows ; ++i )
+			row_sizes[i] = row_offsets[i+1]-row_offsets[i];
+	} else {
+		local_col.resize(header.n_cols);
+		for ( NeuronID j = 0 ; j < header.n_cols ; ++j ) 
+			local_col[j] = dst->localrank(j);
+		for ( NeuronID s = 0 ; s < header.num_sections ; ++s ) {
+			const AurynLong * row_offsets = (const AurynLong *)(base+offsets[s]);
+			const NeuronID * cols = (const NeuronID *)(row_offsets+rows+1);
+			for ( NeuronID i = 0 ; i < rows ; ++i ) 
+				for ( AurynLong k = row_offsets[i] ; k < row_offsets[i+1] ; ++k ) 
+					if ( local_col[cols[k]] ) 
+						row_sizes[i]++;
+		}
+		for ( NeuronID i = 0 ; i < rows ; ++i )
+			nnz += row_sizes[i];
+	}
+
+	if ( m->get_datasize() >= nnz ) {
+		m->clear();
+	} else {
+		stringstream oss;
+		oss << "Buffer too small ("
+			<< m->get_datasize()
+			<< " -> "
+			<< nnz
+			<< " elements). Reallocating.";
+		logger->msg(oss.str() ,NOTIFICATION);
+		m->resize_buffer_and_clear(nnz);
+	}
+
+	stringstream oss;
+	oss << get_name() 
+		<< ": Reading binary matrix from file ("
+		<< get_m_rows()<<"x"<<get_n_cols()
+		<< ", " << ( same_partition ? "own section" : "repartitioning" ) 
+		<< ")";
+	logger->msg(oss.str(),NOTIFICATION);
+
+	m->set_row_sizes(&row_sizes[0]);
+
+	if ( same_partition ) {
+		// copy the section straight into the matrix buffers
+		const char * p = base+offsets[section]+(rows+1)*sizeof(AurynLong);
+		memcpy(m->get_ind_begin(), p, nnz*sizeof(NeuronID));
+		p = base+binary_matrix_align(p-base+nnz*sizeof(NeuronID));
+		for ( StateID z = 0 ; z < z_values ; ++z ) {
+			memcpy(m->get_data_begin(z), p, nnz*sizeof(AurynWeight));
+			p += nnz*sizeof(AurynWeight);
+		}
+	} else {
+		// merge the local columns of each row from all sections
+		vector<binary_matrix_element> row;
+		NeuronID * ind = m->get_ind_begin();
+		AurynLong k = 0;
+		for ( NeuronID i = 0 ; i < rows ; ++i ) {
+			row.clear();
+			for ( NeuronID s = 0 ; s < header.num_sections ; ++s ) {
+				const AurynLong * row_offsets = (const AurynLong *)(base+offsets[s]);
+				const NeuronID * cols = (const NeuronID *)(row_offsets+rows+1);
+				for ( AurynLong r = row_offsets[i] ; r < row_offsets[i+1] ; ++r ) {
+					if ( local_col[cols[r]] ) {
+						binary_matrix_element e;
+						e.col = cols[r];
+						e.pos = r;
+						e.section = s;
+						row.push_back(e);
+					}
+				}
+			}
+			std::sort(row.begin(), row.end());
+			for ( vector<binary_matrix_element>::const_iterator e = row.begin() ; e != row.end() ; ++e, ++k ) {
+				ind[k] = e->col;
+				const AurynLong data_begin = offsets[e->section]
+					+ binary_matrix_align((rows+1)*sizeof(AurynLong)+counts[e->section]*sizeof(NeuronID));
+				const AurynWeight * data = (const AurynWeight *)(base+data_begin);
+				for ( StateID z = 0 ; z < z_values ; ++z ) 
+					m->get_data_begin(z)[k] = data[z*counts[e->section]+e->pos];
+			}
+		}
+	}
+
+	munmap(map, filesize);
+	renumber_matrix(m, false); // the file contains the original ids
+
+	oss.str("");
+	oss << get_name() << ": OK, " 
+		<< m->get_nonzero()
+		<< " elements loaded.";
+	logger->msg(oss.str(),DEBUG);
+
+	return true;
+}
+
+bool SparseConnection::load_from_binary_file(string filename)
+{
+	apply_pending_updates();
+	bool result = load_from_binary_file(w,filename);
+	finalize();
+	return result;
+}
+
 bool SparseConnection::init_from_file(const char * filename)
 {
 	allocate(1);
@@ -869,12 +1488,14 @@ void SparseConnection::put_pattern( type_pattern * pattern1, type_pattern * patt
 		NeuronID j = (*iter_post).i/patterns_every_post;
 		if ( wrap_patterns ) 
 			j = j % get_n_cols();
+		if ( j < dst->get_size() ) j = dst->get_renumbered_id(j); // see System::reorder_neurons
 		if ( j < dst->get_size() && dst->localrank( j ) ) {
 			for ( iter_pre = pattern1->begin() ; iter_pre != pattern1->end() ; ++iter_pre ) {
 				if ( (*iter_pre).i%patterns_every_pre != 0 ) continue;
 				NeuronID i = (*iter_pre).i/patterns_every_pre;
 				if ( wrap_patterns ) 
 					i = i % get_m_rows();
+				if ( i < src->get_size() ) i = src->get_renumbered_id(i);
 				if ( i < src->get_size() && w->exists( i, j ) ) { 
 					if ( overwrite ) {
 						set( i, j, (*iter_post).gamma*strength);
@@ -972,6 +1593,7 @@ void SparseConnection::load_patterns( string filename, AurynWeight strength, int
 
 vector<neuron_pair> SparseConnection::get_block(NeuronID lo_row, NeuronID hi_row,  NeuronID lo_col, NeuronID hi_col) 
 {
+	apply_pending_updates();
 	vector<neuron_pair> clist;
 	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
 	{
@@ -1006,7 +1628,7 @@ vector<neuron_pair> SparseConnection::get_pre_partners(NeuronID j)
 	vector<neuron_pair> clist;
 	for ( NeuronID i = 0 ; i < get_m_rows() ; ++i ) 
 	{
-		if ( get_ptr(i,j) != NULL ) {
+		if ( w->exists(i,j) ) {
 			neuron_pair a;
 			a.i = i;
 			a.j = j;
@@ -1019,6 +1641,11 @@ vector<neuron_pair> SparseConnection::get_pre_partners(NeuronID j)
 
 void SparseConnection::clip(AurynWeight lo, AurynWeight hi)
 {
+	apply_pending_updates();
+	if ( w->is_uniform() ) {
+		w->set_all( min(max(w->get_uniform_value(),lo),hi) );
+		return;
+	}
 	for ( AurynWeight * ptr = w->get_data_begin() ; ptr != w->get_data_end()  ; ++ptr ) {
 		if ( *ptr < lo )
 			*ptr = lo;
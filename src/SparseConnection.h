@@ -30,11 +30,16 @@
 #include "Connection.h"
 #include "System.h"
 #include "ComplexMatrix.h"
+#include "CounterRandomStream.h"
 
 #include <sstream>
 #include <fstream>
 #include <stdio.h>
 #include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
@@ -45,6 +50,11 @@
 
 #define WARN_FILL_LEVEL 0.8
 
+/*! Default of SparseConnection::prefetch_rows_ahead */
+#define DEFAULT_PREFETCH_ROWS_AHEAD 2
+/*! Default of SparseConnection::prefetch_targets_ahead */
+#define DEFAULT_PREFETCH_TARGETS_AHEAD 0
+
 using namespace std;
 
 typedef ComplexMatrix<AurynWeight> ForwardMatrix;
@@ -73,6 +83,7 @@ private:
 protected:
 	void virtual_serialize(boost::archive::binary_oarchive & ar, const unsigned int version ) 
 	{
+		apply_pending_updates();
 		Connection::virtual_serialize(ar,version);
 		ar & *w;
 	}
@@ -92,8 +103,98 @@ protected:
 	void free();
 	void allocate(AurynLong bufsize);
 
+	/*! Moves the elements of m from the current to the original ids of the 
+	 * neurons or back such that weight matrix files are independent of 
+	 * System::reorder_neurons. Moving them forth and back leaves m unchanged. */
+	void renumber_matrix(ForwardMatrix * m, bool to_original);
+
+	/*! Parallel version of connect_block_random which is used when 
+	 * parallel_fill is true. */
+	void connect_block_random_parallel(AurynWeight weight, 
+			float sparseness, 
+			NeuronID lo_row, 
+			NeuronID hi_row, 
+			NeuronID lo_col, 
+			NeuronID hi_col, 
+			bool skip_diag );
+
+	/*! Prefetches the row of the spike prefetch_rows_ahead positions behind 
+	 * spike k in spikes (see prefetch_rows_ahead). */
+	void prefetch_spike_row(const SpikeContainer * spikes, NeuronID k, StateID z=0)
+	{
+		if ( prefetch_rows_ahead && k+prefetch_rows_ahead < spikes->size() ) 
+			w->prefetch_row((*spikes)[k+prefetch_rows_ahead], z);
+	}
+
+	/*! Maps a data index of the forward matrix to the rank local id of its 
+	 * postsynaptic neuron through the global column indices. */
+	struct GlobalTargetIndex {
+		const NeuronID * ind;
+		SpikingGroup * group;
+		NeuronID operator()(AurynLong c) const { return group->global2rank(ind[c]); }
+	};
+	/*! Maps a data index of the forward matrix to the rank local id of its 
+	 * postsynaptic neuron through the 16 bit local column indices. */
+	struct LocalTargetIndex {
+		const unsigned short * local;
+		NeuronID operator()(AurynLong c) const { return local[c]; }
+	};
+	/*! Weight of a uniform matrix */
+	struct UniformValue {
+		AurynWeight value;
+		AurynWeight operator()(AurynLong) const { return value; }
+	};
+	/*! Weight stored in the forward matrix (see ComplexMatrix::get_const_data_begin) */
+	struct MatrixValue {
+		const AurynWeight * data;
+		AurynWeight operator()(AurynLong c) const { return data[c]; }
+	};
+
+	/*! Propagates the rows of all spikes of the current time step. Index maps
+	 * the data index of a synapse to the rank local id of its target and Value
+	 * yields its weight. Prefetches the targets ahead synapses in advance 
+	 * unless ahead is 0. */
+	template <typename Index, typename Value>
+	void propagate_rows(const Index & index, const Value & value, AurynLong ahead);
+
+	/*! Version of propagate which uses the 16 bit rank local column 
+	 * indices of the forward matrix (see ComplexMatrix::get_local_index). */
+	void propagate_local(const unsigned short * local);
+
+	/*! Number of postsynaptic neurons per tile in propagate_tiled or 0 */
+	NeuronID tile_size;
+	/*! Position of each spike's row in propagate_tiled */
+	vector<AurynLong> tile_cursors;
+	/*! Version of propagate which processes the postsynaptic neurons in 
+	 * tiles of tile_size neurons and the rows of all spikes of the current 
+	 * time step for each tile before moving on to the next one. Value yields
+	 * the weight of a synapse like in propagate_rows. */
+	template <typename Value>
+	void propagate_tiled(const Value & value);
 	
 public:
+	/*! Switch that selects the algorithm of connect_block_random. If true, 
+	 * the rows are filled in parallel by the threads set with 
+	 * System::set_num_threads and each row draws its synapses from its own 
+	 * CounterRandomStream. The resulting matrix only depends on the seed and the
+	 * number of ranks, but not on the number of threads. Since it differs from 
+	 * the matrix drawn by the default sequential algorithm, this is false by 
+	 * default. The switch is static because most constructors fill the matrix 
+	 * right away. */
+	static bool parallel_fill;
+
+	/*! Number of spikes propagate looks ahead in the spike list to prefetch the
+	 * beginning of their rows of the weight matrix, such that the jump to the
+	 * next row does not stall on memory. 0 disables the prefetching. 
+	 * Requires CODE_ACTIVATE_PREFETCHING_INTRINSICS. */
+	static unsigned int prefetch_rows_ahead;
+	/*! Number of synapses propagate looks ahead within a row to prefetch the 
+	 * transmitter state of their postsynaptic neurons. Without local column 
+	 * indices each prefetch costs a second global2rank per synapse. 0 (the 
+	 * default) disables the prefetching, since it did not pay off in our 
+	 * measurements. Requires CODE_ACTIVATE_PREFETCHING_INTRINSICS. */
+	static unsigned int prefetch_targets_ahead;
+
 	/*! Switch that toggles for the load_patterns function whether or 
 	 * not to use the intensity (gamma) value. Default is false. */
 	bool patterns_ignore_gamma; 
@@ -172,7 +273,7 @@ public:
 
 	/*! Underlying sparse fill method. Set dist_optimized to false and seed
 	 * all ranks the same to get the same matrix independent of the number
-	 * of ranks. 
+	 * of ranks. See parallel_fill for a multithreaded version.
 	 */ 
 	void connect_block_random(AurynWeight weight, 
 			float sparseness, 
@@ -190,6 +291,23 @@ public:
 	void load_patterns( string filename, AurynWeight strength, bool overwrite = false, bool chainmode = false);
 	void load_patterns( string filename, AurynWeight strength, int n, bool overwrite = false, bool chainmode = false);
 	virtual void propagate();
+	virtual bool allows_temporal_blocking();
+	virtual bool allows_neuron_permutation();
+	virtual void permute_neurons(const vector<NeuronID> * pre_ids, const vector<NeuronID> * post_ids);
+
+	/*! \brief Sets the number of postsynaptic neurons per tile during propagate
+	 *
+	 * For large postsynaptic groups the transmitter state written by propagate
+	 * (e.g. g_ampa) does not fit into cache and most synapses cause a cache miss.
+	 * With a tile size larger than 0 propagate passes over the postsynaptic 
+	 * neurons of the rank in tiles and processes the elements of all rows 
+	 * which spiked in the current time step that fall into a tile before moving 
+	 * on to the next tile. The tile size should be chosen such that a tile of 
+	 * the state vector fits into L2 cache (e.g. 32768 neurons for 128kB). 
+	 * The result is identical to the untiled propagate. Default is 0 (off). */
+	void set_tile_size(NeuronID size);
+	/*! Returns the tile size of propagate (see set_tile_size) */
+	NeuronID get_tile_size();
 
 	/*! Quick an dirty function that checks if all units on the local rank are connected */
 	void sanity_check();
@@ -214,6 +332,25 @@ public:
 	virtual bool load_from_complete_file(string filename);
 	virtual bool load_from_file(string filename);
 
+	/*! \brief Writes the weight matrix in binary CSR format to a single file
+	 *
+	 * The file starts with a header (matrix dimensions, number of synaptic states
+	 * and a table of sections) followed by one section per rank of the
+	 * destination group. Each section holds the column partition of that rank as
+	 * row offsets, column indices and the data of each synaptic state.
+	 * All ranks write their sections in parallel with MPI-IO, so this function
+	 * has to be called on all ranks with the same filename. */
+	bool write_to_binary_file(ForwardMatrix * m, string filename);
+	/*! \brief Loads a weight matrix written by write_to_binary_file
+	 *
+	 * The file is memory mapped. If it was written with the same number of ranks,
+	 * each rank copies its own section straight into the matrix buffers.
+	 * Otherwise the local columns are collected from all sections. */
+	bool load_from_binary_file(ForwardMatrix * m, string filename);
+
+	virtual bool write_to_binary_file(string filename);
+	virtual bool load_from_binary_file(string filename);
+
 	/*! Sets minimum weight (for plastic connections). */
 	virtual void set_min_weight(AurynWeight minimum_weight);
 	AurynWeight get_min_weight();
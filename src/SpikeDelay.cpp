@@ -30,10 +30,16 @@ AurynTime * SpikeDelay::clock_ptr = NULL;
 SpikeDelay::SpikeDelay( int delay )
 {
 	ndelay = delay;
+	nbuffer = delay;
 	numSpikeAttributes = 0;
-	delaybuf = new SpikeContainer * [ndelay] ;
-	attribbuf = new AttributeContainer * [ndelay] ;
-	for (int i = 0 ; i < ndelay ; ++i) {
+	allocate();
+}
+
+void SpikeDelay::allocate()
+{
+	delaybuf = new SpikeContainer * [nbuffer] ;
+	attribbuf = new AttributeContainer * [nbuffer] ;
+	for (int i = 0 ; i < nbuffer ; ++i) {
 		delaybuf[i] = new SpikeContainer( );
 		attribbuf[i] = new AttributeContainer( );
 	}
@@ -43,18 +49,57 @@ void SpikeDelay::set_delay( int delay )
 {
 	if ( delay == ndelay ) return;
 	free();
+	nbuffer += delay-ndelay; // keep block length
 	ndelay = delay;
-	delaybuf = new SpikeContainer * [ndelay] ;
-	attribbuf = new AttributeContainer * [ndelay] ;
-	for (int i = 0 ; i < ndelay ; ++i) {
-		delaybuf[i] = new SpikeContainer( );
-		attribbuf[i] = new AttributeContainer( );
+	allocate();
+}
+
+void SpikeDelay::set_block_length( int steps ) 
+{
+	int n = ndelay+steps-1;
+	if ( n < ndelay ) n = ndelay;
+	if ( n == nbuffer ) return;
+
+	// move the spikes in flight to their slots in the new buffer
+	SpikeContainer ** newdelaybuf = new SpikeContainer * [n] ;
+	AttributeContainer ** newattribbuf = new AttributeContainer * [n] ;
+	for (int i = 0 ; i < n ; ++i) {
+		newdelaybuf[i] = NULL;
+		newattribbuf[i] = NULL;
+	}
+
+	const AurynTime clk = *clock_ptr;
+	for (int pos = 0 ; pos < ndelay ; ++pos) {
+		int from = ( pos == 0 ) ? clk%nbuffer : (clk+pos+nbuffer-ndelay)%nbuffer;
+		int to = ( pos == 0 ) ? clk%n : (clk+pos+n-ndelay)%n;
+		newdelaybuf[to] = delaybuf[from];
+		newattribbuf[to] = attribbuf[from];
+		delaybuf[from] = NULL;
+		attribbuf[from] = NULL;
 	}
+
+	for (int i = 0 ; i < nbuffer ; ++i) {
+		delete delaybuf[i];
+		delete attribbuf[i];
+	}
+	delete [] delaybuf;
+	delete [] attribbuf;
+
+	for (int i = 0 ; i < n ; ++i) {
+		if ( newdelaybuf[i] == NULL ) {
+			newdelaybuf[i] = new SpikeContainer( );
+			newattribbuf[i] = new AttributeContainer( );
+		}
+	}
+
+	delaybuf = newdelaybuf;
+	attribbuf = newattribbuf;
+	nbuffer = n;
 }
 
 void SpikeDelay::free()
 {
-	for (int i = 0 ; i < ndelay ; ++i) {
+	for (int i = 0 ; i < nbuffer ; ++i) {
 		delete delaybuf[i];
 		delete attribbuf[i];
 	}
@@ -64,7 +109,7 @@ void SpikeDelay::free()
 
 void SpikeDelay::clear()
 {
-	for (int i = 0 ; i < ndelay ; ++i) {
+	for (int i = 0 ; i < nbuffer ; ++i) {
 		delaybuf[i]->clear();
 		attribbuf[i]->clear();
 	}
@@ -77,7 +122,8 @@ SpikeDelay::~SpikeDelay()
 
 SpikeContainer * SpikeDelay::get_spikes(unsigned int pos)
 {
-	return delaybuf[((*clock_ptr)+pos)%ndelay]; 
+	if ( pos == 0 ) return delaybuf[(*clock_ptr)%nbuffer];
+	return delaybuf[((*clock_ptr)+pos+nbuffer-ndelay)%nbuffer]; 
 }
 
 SpikeContainer * SpikeDelay::get_spikes_immediate()
@@ -87,7 +133,8 @@ SpikeContainer * SpikeDelay::get_spikes_immediate()
 
 AttributeContainer * SpikeDelay::get_attributes(unsigned int pos)
 {
-	return attribbuf[((*clock_ptr)+pos)%ndelay]; 
+	if ( pos == 0 ) return attribbuf[(*clock_ptr)%nbuffer];
+	return attribbuf[((*clock_ptr)+pos+nbuffer-ndelay)%nbuffer]; 
 }
 
 AttributeContainer * SpikeDelay::get_attributes_immediate()
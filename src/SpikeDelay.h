@@ -69,8 +69,13 @@ class SpikeDelay
 
 		static AurynTime * clock_ptr;
 
+		/*! Axonal delay in time steps + 1 */
 		int ndelay;
+		/*! Number of slots in the ring buffer. Equals ndelay unless the delay
+		 * has to hold the spikes of several steps ahead (see set_block_length) */
+		int nbuffer;
 		void free();
+		void allocate();
 
 	public:
 
@@ -81,6 +86,13 @@ class SpikeDelay
 		void set_delay( int delay);
 		void set_clock_ptr(AurynTime * clock);
 
+		/*! Enlarges the ring buffer such that a group can run up to steps 
+		 * time steps ahead of the Connections reading from it without 
+		 * overwriting spikes which have not been delivered yet. Used for 
+		 * temporal blocking (see System::set_temporal_blocking). The spikes
+		 * in the delay are kept. */
+		void set_block_length( int steps );
+
 		/*! Allows to insert spikes so many time steps ahead with less than max delay. */
 		void insert_spike(NeuronID i, AurynTime ahead); 
 
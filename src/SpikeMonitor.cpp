@@ -79,9 +79,15 @@ void SpikeMonitor::set_every(NeuronID every)
 void SpikeMonitor::propagate()
 {
 	for (it = src->get_spikes_immediate()->begin() ; it < src->get_spikes_immediate()->end() ; ++it ) {
-		if (*it >= n_from ) {
-			if ( *it < n_to && (*it%n_every==0) ) 
-			 outfile << dt*(sys->get_clock()) << "  " << *it+offset << "\n";
+		const NeuronID id = src->get_original_id(*it);
+		if (id >= n_from ) {
+			if ( id < n_to && (id%n_every==0) ) 
+			 outfile << dt*(sys->get_clock()) << "  " << id+offset << "\n";
 		}
 	}
 }
+
+SpikingGroup * SpikeMonitor::get_source()
+{
+	return src;
+}
@@ -61,6 +61,7 @@ public:
 	void set_every(NeuronID every);
 	virtual ~SpikeMonitor();
 	void propagate();
+	virtual SpikingGroup * get_source();
 };
 
 #endif /*SPIKEMONITOR_H_*/
@@ -36,6 +36,16 @@ vector<mpi::request> SpikingGroup::reqs;
 
 NeuronID SpikingGroup::anticipated_total = 0;
 
+vector<double> SpikingGroup::measured_load_shares;
+
+vector<NeuronID> SpikingGroup::measured_load_sizes;
+
+NeuronID SpikingGroup::measured_load_offset = 0;
+
+vector<unsigned int> SpikingGroup::planned_locked_ranks;
+
+vector<unsigned int> SpikingGroup::planned_locked_ranges;
+
 
 
 SpikingGroup::SpikingGroup(NeuronID n, double loadmultiplier, NeuronID total ) 
@@ -64,6 +74,7 @@ void SpikingGroup::init(NeuronID n, double loadmultiplier, NeuronID total )
 
 	// setting up default values
 	evolve_locally_bool = true;
+	evolve_concurrently_bool = false;
 	locked_rank = 0;
 	locked_range = communicator->size();
 	rank_size = calculate_rank_size(); // set the rank size
@@ -73,8 +84,30 @@ void SpikingGroup::init(NeuronID n, double loadmultiplier, NeuronID total )
 	if ( anticipated_total > 0 )
 		fraction = (1.*size*effective_load_multiplier)/anticipated_total;
 
-	if ( fraction >= 0 && fraction < 1. ) { 
-		lock_range( fraction );
+	// measured loads take precedence over the load multiplier
+	bool planned = false;
+	NeuronID profile_index = unique_id-measured_load_offset;
+	if ( profile_index < measured_load_shares.size() ) {
+		if ( measured_load_sizes[profile_index] == size ) {
+			NeuronID profile_total = 0;
+			for ( NeuronID i = 0 ; i < measured_load_sizes.size() ; ++i ) 
+				profile_total += measured_load_sizes[i];
+			fraction = measured_load_shares[profile_index];
+			effective_load_multiplier = fraction*profile_total/size;
+			planned = true;
+
+			stringstream oss;
+			oss << get_name() << ":: Using measured load share " << fraction;
+			logger->msg(oss.str(),NOTIFICATION);
+		} else {
+			stringstream oss;
+			oss << get_name() << ":: Size does not match the load profile. Ignoring measured load.";
+			logger->msg(oss.str(),WARNING);
+		}
+	}
+
+	if ( planned || ( fraction >= 0 && fraction < 1. ) ) { 
+		lock_range( fraction, planned );
 	} else { // ROUNDROBIN which is default
 		locked_rank = 0;
 		locked_range = communicator->size();
@@ -94,13 +127,18 @@ void SpikingGroup::init(NeuronID n, double loadmultiplier, NeuronID total )
 	evolve_locally_bool = evolve_locally_bool && ( get_rank_size() > 0 );
 }
 
-void SpikingGroup::lock_range( double rank_fraction )
+void SpikingGroup::lock_range( double rank_fraction, bool planned )
 {
 	locked_rank = last_locked_rank%communicator->size(); // TODO might cause a bug with the block lock stuff
 
 	// TODO get the loads for the different ranks and try to minimize this
+	// (currently only done when a measured load profile is set)
 
-	if ( rank_fraction == 0 ) { // this is the classical rank lock to one single rank
+	if ( planned ) { // use the ranks planned from the measured load profile
+		NeuronID profile_index = unique_id-measured_load_offset;
+		locked_rank = planned_locked_ranks[profile_index];
+		locked_range = planned_locked_ranges[profile_index];
+	} else if ( rank_fraction == 0 ) { // this is the classical rank lock to one single rank
 		stringstream oss;
 		oss << get_name() << ":: Groups demands to run on single rank only (RANKLOCK).";
 		logger->msg(oss.str(),NOTIFICATION);
@@ -216,6 +254,22 @@ void SpikingGroup::push_spike(NeuronID spike)
 	spikes->push_back(rank2global(spike));
 }
 
+void SpikingGroup::push_spikes(const unsigned char * flags, NeuronID begin, NeuronID end) 
+{
+	NeuronID i = begin;
+	const __m128i zero = _mm_setzero_si128();
+	for ( ; i+16 <= end ; i += 16 ) {
+		const __m128i chunk = _mm_loadu_si128( (const __m128i*)(flags+i-begin) );
+		unsigned int mask = ~_mm_movemask_epi8( _mm_cmpeq_epi8( chunk, zero ) ) & 0xFFFF;
+		while ( mask ) { // compaction of the set bits
+			push_spike( i + __builtin_ctz(mask) );
+			mask &= mask-1;
+		}
+	}
+	for ( ; i < end ; ++i ) 
+		if ( flags[i-begin] ) push_spike(i);
+}
+
 void SpikingGroup::push_attribute(AurynFloat attrib) 
 {
 	attribs->push_back(attrib);
@@ -265,16 +319,118 @@ AurynDouble SpikingGroup::get_effective_load()
 	return get_rank_size()*effective_load_multiplier;
 }
 
+void SpikingGroup::set_load_profile(vector<NeuronID> sizes, vector<double> shares)
+{
+	measured_load_sizes = sizes;
+	measured_load_shares = shares;
+	measured_load_offset = unique_id_count;
+	last_locked_rank = 0;
+
+	const unsigned int ranks = communicator->size();
+	const unsigned int n = shares.size();
+	planned_locked_ranks.assign(n,0);
+	planned_locked_ranges.assign(n,ranks);
+
+	// place the most expensive groups first
+	vector< pair<double,unsigned int> > order;
+	for ( unsigned int i = 0 ; i < n ; ++i ) 
+		order.push_back( make_pair(-shares[i],i) );
+	sort(order.begin(), order.end());
+
+	vector<double> rank_loads(ranks,0.0);
+	for ( unsigned int k = 0 ; k < n ; ++k ) {
+		const unsigned int i = order[k].second;
+
+		unsigned int max_range = sizes[i]/DEFAULT_MINDISTRIBUTEDSIZE;
+		if ( max_range < 1 ) max_range = 1;
+		if ( max_range > ranks ) max_range = ranks;
+
+		// find the block of ranks which keeps the busiest rank in it least loaded
+		double lowest = -1.;
+		for ( unsigned int range = 1 ; range <= max_range ; ++range ) {
+			for ( unsigned int r = 0 ; r+range <= ranks ; ++r ) {
+				double load = 0.;
+				for ( unsigned int j = r ; j < r+range ; ++j ) 
+					load = max(load,rank_loads[j]);
+				load += shares[i]/range;
+				if ( lowest < 0 || load < lowest ) {
+					lowest = load;
+					planned_locked_ranks[i] = r;
+					planned_locked_ranges[i] = range;
+				}
+			}
+		}
+
+		for ( unsigned int j = planned_locked_ranks[i] ; j < planned_locked_ranks[i]+planned_locked_ranges[i] ; ++j ) 
+			rank_loads[j] += shares[i]/planned_locked_ranges[i];
+	}
+
+	double mean = 0.;
+	double busiest = 0.;
+	for ( unsigned int j = 0 ; j < ranks ; ++j ) {
+		mean += rank_loads[j]/ranks;
+		busiest = max(busiest,rank_loads[j]);
+	}
+
+	stringstream oss;
+	oss << "SpikingGroup:: Planned distribution of " << n 
+		<< " groups from load profile with predicted imbalance (max/mean) " << busiest/mean;
+	logger->msg(oss.str(),NOTIFICATION);
+}
 
 NeuronID SpikingGroup::rank2global(NeuronID i) {
 	return i*locked_range+(communicator->rank()-locked_rank);
 }
 
+void SpikingGroup::permute_neurons(const vector<NeuronID> & new_ids)
+{
+	// local state vectors
+	vector<AurynState> tmp(get_rank_size());
+	for ( map<string,auryn_vector_float *>::const_iterator iter = state_vectors.begin() ; 
+			iter != state_vectors.end() ;
+			++iter ) {
+		for ( NeuronID i = 0 ; i < get_rank_size() ; ++i ) 
+			tmp[global2rank(new_ids[rank2global(i)])] = iter->second->data[i];
+		std::copy(tmp.begin(), tmp.end(), iter->second->data);
+	}
+
+	// traces of the neurons on this rank
+	for ( NeuronID k = 0 ; k < posttraces.size() ; ++k ) {
+		for ( NeuronID i = 0 ; i < get_rank_size() ; ++i ) 
+			tmp[global2rank(new_ids[rank2global(i)])] = posttraces[k]->get(i);
+		for ( NeuronID i = 0 ; i < get_rank_size() ; ++i ) 
+			posttraces[k]->set(i, tmp[i]);
+	}
+
+	// traces of all neurons
+	vector<AurynFloat> gtmp(get_size());
+	for ( NeuronID k = 0 ; k < pretraces.size() ; ++k ) {
+		for ( NeuronID i = 0 ; i < get_size() ; ++i ) 
+			gtmp[new_ids[i]] = pretraces[k]->get(i);
+		for ( NeuronID i = 0 ; i < get_size() ; ++i ) 
+			pretraces[k]->set(i, gtmp[i]);
+	}
+
+	// keep track of the original ids
+	vector<NeuronID> ids(get_size());
+	for ( NeuronID i = 0 ; i < get_size() ; ++i ) 
+		ids[new_ids[i]] = get_original_id(i);
+	original_ids.swap(ids);
+	renumbered_ids.resize(get_size());
+	for ( NeuronID i = 0 ; i < get_size() ; ++i ) 
+		renumbered_ids[original_ids[i]] = i;
+}
+
 bool SpikingGroup::evolve_locally()
 {
 	return evolve_locally_bool;
 }
 
+bool SpikingGroup::evolve_concurrently()
+{
+	return evolve_concurrently_bool;
+}
+
 
 unsigned int SpikingGroup::get_locked_rank()
 {
@@ -379,7 +535,7 @@ string SpikingGroup::get_name()
 }
 
 bool SpikingGroup::localrank(NeuronID i) {
-	bool t = ( (i+locked_rank)%locked_range==communicator->rank() )
+	bool t = ( i%locked_range+locked_rank==communicator->rank() ) // inverse of rank2global
 		 && (int) communicator->rank() >= locked_rank
 		 && (int) communicator->rank() < (locked_rank+locked_range)
 		 && i/locked_range < get_rank_size(); 
@@ -72,7 +72,22 @@ private:
 	/*! Stores the number of anticipated units to optimize loadbalancing */
 	static NeuronID anticipated_total;
 
-	void lock_range( double rank_fraction );
+	/*! Measured share of the total load of each SpikingGroup in order of creation (see set_load_profile) */
+	static vector<double> measured_load_shares;
+	/*! Sizes of the SpikingGroups in the load profile */
+	static vector<NeuronID> measured_load_sizes;
+	/*! Unique id of the first SpikingGroup the load profile applies to */
+	static NeuronID measured_load_offset;
+	/*! First rank of each SpikingGroup in the load profile as planned by set_load_profile */
+	static vector<unsigned int> planned_locked_ranks;
+	/*! Number of ranks of each SpikingGroup in the load profile as planned by set_load_profile */
+	static vector<unsigned int> planned_locked_ranges;
+
+	/*! Locks the group to a range of ranks 
+	 * \param rank_fraction Fraction of the ranks to use (0 locks to a single rank)
+	 * \param planned Uses the ranks planned from the measured load profile 
+	 * instead of filling the ranks in order */
+	void lock_range( double rank_fraction, bool planned=false );
 	/*! If not distributed the first rank to lock it to. */
 	unsigned int locked_rank;
 	/*! If not distributed the number of ranks to lock it to. */
@@ -89,6 +104,11 @@ private:
 	/*! Stores axonal delay value - by default MINDELAY */
 	int axonaldelay;
 
+	/*! Original id of each neuron after permute_neurons. Empty if the neurons have not been renumbered. */
+	vector<NeuronID> original_ids;
+	/*! Current id of each original neuron (inverse of original_ids) */
+	vector<NeuronID> renumbered_ids;
+
 protected:
 	/*! Pretraces */
 	vector<PRE_TRACE_MODEL *> pretraces;
@@ -110,6 +130,11 @@ protected:
 	/*! Stores the length of output delay */
 	static AurynTime * clock_ptr;
 
+	/*! Is true if evolve() only touches state owned by this group. Groups that
+	 * draw from shared (static) random number generators leave this false and
+	 * are evolved serially by System even when multithreading is enabled. */
+	bool evolve_concurrently_bool;
+
 	/* Functions related to loading and storing the state from files */
 	virtual void load_input_line(NeuronID i, const char * buf);
 	virtual string get_output_line(NeuronID i);
@@ -170,10 +195,25 @@ public:
 	/*! Returns the effective load of the group. */
 	AurynDouble get_effective_load();
 
+	/*! Sets the measured load profile used to distribute SpikingGroups over ranks.
+	 * The profile applies to the SpikingGroups created after this call in the 
+	 * same order as they were created in the run in which the profile was 
+	 * measured. Starting with the most expensive group, each group is assigned 
+	 * the block of ranks which minimizes the predicted load of the busiest rank.
+	 * As for the default distribution, groups are not spread so thin that fewer 
+	 * than DEFAULT_MINDISTRIBUTEDSIZE units end up on a rank.
+	 * Use System::load_load_profile to read a profile from file.
+	 * \param sizes Sizes of the groups in the profile (used for consistency checks)
+	 * \param shares Measured share of the total load of each group */
+	static void set_load_profile(vector<NeuronID> sizes, vector<double> shares);
+
 	void set_clock_ptr(AurynTime * clock);
 	/*! Returns true if this group is hosted at a single CPU. */
 	bool evolve_locally();
 
+	/*! Returns true if evolve() can run concurrently to other groups on the same rank. */
+	bool evolve_concurrently();
+
 	/*! Evolves traces */
 	void evolve_traces();
 
@@ -192,6 +232,11 @@ public:
 
 	void push_spike(NeuronID spike);
 
+	/*! Pushes a spike for every unit i in [begin:end) with nonzero flags[i-begin]. 
+	 * The flags are tested 16 at a time with SIMD compares so that blocks
+	 * without spikes are skipped quickly and the units are pushed in order. */
+	void push_spikes(const unsigned char * flags, NeuronID begin, NeuronID end);
+
 	void push_attribute(AurynFloat attrib);
 
 	/*! Clear all spikes stored in the delays which is useful to reset a network during runtime */
@@ -208,6 +253,21 @@ public:
 	NeuronID rank2global(NeuronID i);
 	bool localrank(NeuronID i);
 
+	/*! \brief Renumbers the neurons of the group
+	 *
+	 * Neuron i becomes neuron new_ids[i]. Neurons are only renumbered within 
+	 * their rank, i.e. new_ids[i] has to be on the same rank as i. The state 
+	 * vectors and traces are permuted accordingly. Other state of derived 
+	 * classes is not moved, which is why this should only be done right after 
+	 * the network has been set up. The Connections from and to the group have
+	 * to be renumbered as well (see System::reorder_neurons, which takes care of
+	 * both). The original ids are retained (see get_original_id). */
+	void permute_neurons(const vector<NeuronID> & new_ids);
+	/*! Returns the id neuron i had before it was renumbered by permute_neurons. */
+	NeuronID get_original_id(NeuronID i);
+	/*! Returns the current id of the neuron which originally had id i. */
+	NeuronID get_renumbered_id(NeuronID i);
+
 	/*! Rank size but rounded up to multiples of 4 for SSE compatibility */
 	NeuronID get_vector_size();
 
@@ -235,6 +295,18 @@ inline NeuronID SpikingGroup::get_rank_size()
 	return rank_size;
 } 
 
+inline NeuronID SpikingGroup::get_original_id(NeuronID i)
+{
+	if ( original_ids.empty() ) return i;
+	return original_ids[i];
+}
+
+inline NeuronID SpikingGroup::get_renumbered_id(NeuronID i)
+{
+	if ( renumbered_ids.empty() ) return i;
+	return renumbered_ids[i];
+}
+
 
 
 #endif /*SPIKINGGROUP_H_*/
@@ -36,6 +36,7 @@ StateMonitor::~StateMonitor()
 
 void StateMonitor::init(NeuronGroup * source, NeuronID id, string statename, string filename, AurynTime stepsize)
 {
+	if ( id < source->get_size() ) id = source->get_renumbered_id(id); // see System::reorder_neurons
 	if ( !source->localrank(id) ) return; // do not register if neuron is not on the local rank
 
 	Monitor::init(filename);
@@ -60,3 +61,17 @@ void StateMonitor::propagate()
 		outfile << dt*(sys->get_clock()) << " " << *target_variable << "\n";
 	}
 }
+
+void StateMonitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+	if ( group != src || nid >= src->get_rank_size() ) return;
+	// the state vectors are permuted in place
+	const NeuronID x = src->global2rank(new_ids[src->rank2global(nid)]);
+	target_variable += (ptrdiff_t)x-(ptrdiff_t)nid;
+	nid = x;
+}
+
+SpikingGroup * StateMonitor::get_source()
+{
+	return src;
+}
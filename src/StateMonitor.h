@@ -63,6 +63,10 @@ public:
 	StateMonitor(NeuronGroup * source, NeuronID id, string statename, string filename, AurynDouble sampling_interval=dt);
 	virtual ~StateMonitor();
 	void propagate();
+	/*! Follows the recorded neuron when its group is renumbered */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
+	/*! Returns the source group (see Monitor::get_source) */
+	virtual SpikingGroup * get_source();
 };
 
 #endif /*STATEMONITOR_H_*/
@@ -42,6 +42,7 @@ void SymmetricSTDPConnection::init(AurynFloat eta, AurynFloat kappa, AurynFloat
 
 	tr_pre = src->get_pre_trace(tau_stdp);
 	tr_post = dst->get_post_trace(tau_stdp);
+	lazy_pre_trace = tr_pre;
 
 }
 
@@ -100,37 +101,37 @@ inline void SymmetricSTDPConnection::propagate_forward()
 	for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ; // spike = pre_spike
 			spike != spikes_end ; ++spike ) {
 		for (NeuronID * c = w->get_row_begin(*spike) ; c != w->get_row_end(*spike) ; ++c ) {
+			NeuronID translated_spike = dst->global2rank(*c);
+			if ( lazy_updates ) 
+				apply_pending_post_spikes(*spike, translated_spike, data+(c-ind));
 			value = data[c-ind]; 
 			// dst->tadd( *c , value , transmitter );
 			transmit( *c, value );
-			NeuronID translated_spike = dst->global2rank(*c);
 			  data[c-ind] += dw_pre(translated_spike);
 			if (data[c-ind] < get_min_weight()) {
 				data[c-ind] = get_min_weight();
 			}
 		}
+		if ( lazy_updates ) update_pending_row(*spike);
 	}
 }
 
 inline void SymmetricSTDPConnection::propagate_backward()
 {
-	NeuronID * ind = bkw->get_row_begin(0); // first element of index array
-	AurynWeight ** data = bkw->get_data_begin();
+	if ( lazy_updates ) {
+		if ( !stdp_active ) return;
+		for (SpikeContainer::const_iterator spike = dst->get_spikes_immediate()->begin() ; // spike = post_spike
+				spike != dst->get_spikes_immediate()->end() ; ++spike ) 
+			add_pending_post_spike(dst->global2rank(*spike), learning_rate);
+		return;
+	}
+
+	// dw_post vanishes when stdp is inactive, but the weights are still clipped
+	const AurynFloat eta = stdp_active ? learning_rate : 0.;
 	SpikeContainer::const_iterator spikes_end = dst->get_spikes_immediate()->end();
 	for (SpikeContainer::const_iterator spike = dst->get_spikes_immediate()->begin() ; // spike = post_spike
-			spike != spikes_end ; ++spike ) {
-		for (NeuronID * c = bkw->get_row_begin(*spike) ; c != bkw->get_row_end(*spike) ; ++c ) {
-
-			#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
-			_mm_prefetch((const char *)data[c-ind+2],  _MM_HINT_NTA);
-			#endif
-			
-			*data[c-ind] += dw_post(*c);
-			if (*data[c-ind] > get_max_weight()) {
-				*data[c-ind] = get_max_weight();
-			}
-		}
-	}
+			spike != spikes_end ; ++spike ) 
+		add_to_bkw_row(*spike, tr_pre, eta);
 }
 
 void SymmetricSTDPConnection::propagate()
@@ -43,6 +43,9 @@ void SyncBuffer::init()
 
 	overflow_value = -1;
 
+	point_to_point = false;
+	routing_num_groups = 0;
+
 
 	maxSendSum = 0;
 	maxSendSum2 = 0;
@@ -65,6 +68,9 @@ void SyncBuffer::init()
 
 void SyncBuffer::push(SpikeDelay * delay, NeuronID size)
 {
+	// remember where the data of this group starts for the point-to-point exchange
+	group_begin.push_back(send_buf.size());
+	const NeuronID spikes_before = send_buf[0];
 
 	for (NeuronID i = 1 ; i < MINDELAY+1 ; ++i ) {
 		SpikeContainer * sc = delay->get_spikes(i);
@@ -98,6 +104,7 @@ void SyncBuffer::push(SpikeDelay * delay, NeuronID size)
 		}
 	}
 
+	group_spikes.push_back(send_buf[0]-spikes_before);
 	groupPushOffset1 += size*MINDELAY;
 }
 
@@ -109,9 +116,11 @@ void SyncBuffer::pop(SpikeDelay * delay, NeuronID size)
 	}
 
 
-	for (int r = 0 ; r < mpicom->size() ; ++r ) {
-		NeuronID numberOfSpikes = recv_buf[r*max_send_size]; // total data
-		NeuronID * iter = &recv_buf[r*max_send_size+pop_offsets[r]]; // first spike
+	const int num_sources = point_to_point ? recv_ranks.size() : mpicom->size();
+	for (int r = 0 ; r < num_sources ; ++r ) {
+		NeuronID * section = get_recv_section(r);
+		NeuronID numberOfSpikes = section[0]; // total data
+		NeuronID * iter = section+pop_offsets[r]; // first spike
 
 		NeuronID temp  = (*iter - groupPopOffset);
 		NeuronID spike = temp%size; // spike (if it exists) in current group
@@ -149,8 +158,8 @@ void SyncBuffer::pop(SpikeDelay * delay, NeuronID size)
 			}
 		}
 
-		recv_buf[r*max_send_size] = numberOfSpikes; // save remaining entries
-		pop_offsets[r] = iter - &recv_buf[r*max_send_size]; // save offset in recv_buf section
+		section[0] = numberOfSpikes; // save remaining entries
+		pop_offsets[r] = iter - section; // save offset in recv_buf section
 	}
 
 	groupPopOffset += size*MINDELAY;
@@ -160,6 +169,24 @@ void SyncBuffer::pop(SpikeDelay * delay, NeuronID size)
 
 void SyncBuffer::sync() 
 {
+	sync_start();
+	sync_finish();
+}
+
+NeuronID * SyncBuffer::get_recv_section(int r)
+{
+	if ( point_to_point ) 
+		return &p2p_recv_bufs[r][0];
+	return &recv_buf[r*max_send_size];
+}
+
+void SyncBuffer::sync_start() 
+{
+	if ( point_to_point ) {
+		p2p_sync_start();
+		return;
+	}
+
 	if ( syncCount >= SYNCBUFFER_SIZE_HIST_LEN ) {  // update the estimate of maximum send size
 		NeuronID mean_send_size =  maxSendSum/syncCount; // allow for 5 times the max mean
 		NeuronID var_send_size  =  (maxSendSum2-mean_send_size*mean_send_size)/syncCount;
@@ -174,29 +201,56 @@ void SyncBuffer::sync()
 		syncCount = 0;
 	}
 
-	int ierr;
+	NeuronID * send_data = send_buf.data();
+	int send_count = send_buf.size();
+
+	if ( send_buf.size() > max_send_size ) {
+		// Create a overflow package 
+		overflow_data[0] = -1;
+		overflow_data[1] = send_buf.size(); 
+		send_data = overflow_data;
+		send_count = 2;
+	}
 
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
 	double T1, T2;              
     T1 = MPI_Wtime();     /* start time */
 #endif
-	if ( send_buf.size() <= max_send_size ) {
-		ierr = MPI_Allgather(send_buf.data(), send_buf.size(), MPI_UNSIGNED, 
-				recv_buf.data(), max_send_size, MPI_UNSIGNED, *mpicom);
-	} else { 
-		// Create a overflow package 
-		NeuronID * overflow_data  = new NeuronID[2];
-		overflow_data[0] = -1;
-		overflow_data[1] = send_buf.size(); 
-		ierr = MPI_Allgather(overflow_data, 2, MPI_UNSIGNED, 
-				recv_buf.data(), max_send_size, MPI_UNSIGNED, *mpicom);
-		delete overflow_data;
+
+#ifdef CODE_USE_NONBLOCKING_SYNC
+	MPI_Iallgather(send_data, send_count, MPI_UNSIGNED, 
+			recv_buf.data(), max_send_size, MPI_UNSIGNED, *mpicom, &sync_request);
+#else
+	MPI_Allgather(send_data, send_count, MPI_UNSIGNED, 
+			recv_buf.data(), max_send_size, MPI_UNSIGNED, *mpicom);
+#endif
+
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+    T2 = MPI_Wtime();     /* end time */
+	deltaT += (T2-T1);
+#endif
+}
+
+void SyncBuffer::sync_finish() 
+{
+	if ( point_to_point ) {
+		p2p_sync_finish();
+		return;
 	}
 
+#ifdef CODE_USE_NONBLOCKING_SYNC
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+	double T1, T2;              
+    T1 = MPI_Wtime();     /* start time */
+#endif
+
+	MPI_Wait(&sync_request, MPI_STATUS_IGNORE);
+
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
     T2 = MPI_Wtime();     /* end time */
 	deltaT += (T2-T1);
 #endif
+#endif /* CODE_USE_NONBLOCKING_SYNC */
 
 	/* Detect over flow */
 	bool overflow = false;
@@ -223,7 +277,7 @@ void SyncBuffer::sync()
 		recv_buf.resize(mpicom->size()*max_send_size);
 		// sync(); // recursive retry was ausing problems
 		// resend full buffer
-		ierr = MPI_Allgather(send_buf.data(), send_buf.size(), MPI_UNSIGNED, 
+		MPI_Allgather(send_buf.data(), send_buf.size(), MPI_UNSIGNED, 
 				recv_buf.data(), max_send_size, MPI_UNSIGNED, *mpicom);
 	} 
 
@@ -244,10 +298,156 @@ void SyncBuffer::sync()
 	reset_send_buffer();
 }
 
+void SyncBuffer::p2p_sync_start() 
+{
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+	double T1, T2;              
+    T1 = MPI_Wtime();     /* start time */
+#endif
+
+	for ( unsigned int k = 0 ; k < recv_ranks.size() ; ++k ) 
+		MPI_Irecv(&p2p_recv_bufs[k][0], recv_capacities[k], MPI_UNSIGNED, 
+				recv_ranks[k], SYNCBUFFER_P2P_TAG, *mpicom, &p2p_recv_requests[k]);
+
+	// assemble the groups needed by each send rank in the usual format
+	const unsigned int num_groups = group_begin.size();
+	for ( unsigned int k = 0 ; k < send_ranks.size() ; ++k ) {
+		vector<NeuronID> & buf = p2p_send_bufs[k];
+		buf.clear();
+		buf.push_back(0);
+		for ( unsigned int g = 0 ; g < num_groups ; ++g ) {
+			if ( g < routing_num_groups && !send_routes[k*routing_num_groups+g] ) continue;
+			const NeuronID end = ( g+1 < num_groups ) ? group_begin[g+1] : send_buf.size();
+			buf[0] += group_spikes[g];
+			buf.insert(buf.end(), send_buf.begin()+group_begin[g], send_buf.begin()+end);
+		}
+
+		if ( buf.size() > send_capacities[k] ) {
+			// signal the overflow and send the full buffer with a different tag 
+			p2p_overflow_data[2*k] = overflow_value;
+			p2p_overflow_data[2*k+1] = buf.size();
+			MPI_Isend(&p2p_overflow_data[2*k], 2, MPI_UNSIGNED, 
+					send_ranks[k], SYNCBUFFER_P2P_TAG, *mpicom, &p2p_send_requests[2*k]);
+			MPI_Isend(&buf[0], buf.size(), MPI_UNSIGNED, 
+					send_ranks[k], SYNCBUFFER_P2P_OVERFLOW_TAG, *mpicom, &p2p_send_requests[2*k+1]);
+			send_capacities[k] = 2*buf.size();
+		} else {
+			MPI_Isend(&buf[0], buf.size(), MPI_UNSIGNED, 
+					send_ranks[k], SYNCBUFFER_P2P_TAG, *mpicom, &p2p_send_requests[2*k]);
+			p2p_send_requests[2*k+1] = MPI_REQUEST_NULL;
+		}
+	}
+
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+    T2 = MPI_Wtime();     /* end time */
+	deltaT += (T2-T1);
+#endif
+}
+
+void SyncBuffer::p2p_sync_finish() 
+{
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+	double T1, T2;              
+    T1 = MPI_Wtime();     /* start time */
+#endif
+
+	if ( !p2p_recv_requests.empty() )
+		MPI_Waitall(p2p_recv_requests.size(), &p2p_recv_requests[0], MPI_STATUSES_IGNORE);
+
+	for ( unsigned int k = 0 ; k < recv_ranks.size() ; ++k ) {
+		if ( p2p_recv_bufs[k][0] == overflow_value ) {
+			const NeuronID n = p2p_recv_bufs[k][1];
+			recv_capacities[k] = 2*n; // same rule as on the sending side
+			p2p_recv_bufs[k].resize(recv_capacities[k]+1);
+			MPI_Recv(&p2p_recv_bufs[k][0], n, MPI_UNSIGNED, 
+					recv_ranks[k], SYNCBUFFER_P2P_OVERFLOW_TAG, *mpicom, MPI_STATUS_IGNORE);
+		}
+	}
+
+	if ( !p2p_send_requests.empty() )
+		MPI_Waitall(p2p_send_requests.size(), &p2p_send_requests[0], MPI_STATUSES_IGNORE);
+
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+    T2 = MPI_Wtime();     /* end time */
+	deltaT += (T2-T1);
+#endif
+
+	for (vector<NeuronID>::iterator iter = pop_offsets.begin() ;
+			iter != pop_offsets.end() ;
+			++iter ) 
+		*iter = 1;
+
+	reset_send_buffer();
+}
+
+void SyncBuffer::set_routing(const vector<char> & evolves, const vector<char> & needs, unsigned int num_groups)
+{
+	const int rank = mpicom->rank();
+
+	send_ranks.clear();
+	recv_ranks.clear();
+	send_routes.clear();
+	for ( int r = 0 ; r < mpicom->size() ; ++r ) {
+		bool send = false;
+		bool recv = false;
+		vector<char> routes(num_groups,0);
+		for ( unsigned int g = 0 ; g < num_groups ; ++g ) {
+			if ( evolves[rank*num_groups+g] && needs[r*num_groups+g] ) {
+				routes[g] = 1;
+				send = true;
+			}
+			if ( needs[rank*num_groups+g] && evolves[r*num_groups+g] ) 
+				recv = true;
+		}
+		if ( send ) {
+			send_ranks.push_back(r);
+			send_routes.insert(send_routes.end(), routes.begin(), routes.end());
+		}
+		if ( recv ) 
+			recv_ranks.push_back(r);
+	}
+	routing_num_groups = num_groups;
+
+	send_capacities.assign(send_ranks.size(), SYNCBUFFER_P2P_INITIAL_CAPACITY);
+	recv_capacities.assign(recv_ranks.size(), SYNCBUFFER_P2P_INITIAL_CAPACITY);
+	p2p_send_bufs.assign(send_ranks.size(), vector<NeuronID>());
+	// one extra element because pop() peeks behind the last spike
+	p2p_recv_bufs.assign(recv_ranks.size(), vector<NeuronID>(SYNCBUFFER_P2P_INITIAL_CAPACITY+1,0)); 
+	p2p_overflow_data.assign(2*send_ranks.size(), 0);
+	p2p_send_requests.assign(2*send_ranks.size(), MPI_REQUEST_NULL);
+	p2p_recv_requests.assign(recv_ranks.size(), MPI_REQUEST_NULL);
+
+	point_to_point = true;
+}
+
+void SyncBuffer::clear_routing()
+{
+	point_to_point = false;
+	send_ranks.clear();
+	recv_ranks.clear();
+	send_routes.clear();
+	p2p_send_bufs.clear();
+	p2p_recv_bufs.clear();
+}
+
+unsigned int SyncBuffer::get_num_send_ranks()
+{
+	if ( point_to_point ) return send_ranks.size();
+	return mpicom->size();
+}
+
+unsigned int SyncBuffer::get_num_recv_ranks()
+{
+	if ( point_to_point ) return recv_ranks.size();
+	return mpicom->size();
+}
+
 void SyncBuffer::reset_send_buffer()
 {
 	send_buf.clear();
 	send_buf.push_back(0); // initial size first entry
+	group_begin.clear();
+	group_spikes.clear();
 	groupPushOffset1 = 0;
 	groupPopOffset = 0;
 }
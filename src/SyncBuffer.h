@@ -28,6 +28,9 @@
 
 #define SYNCBUFFER_SIZE_MARGIN_MULTIPLIER 3 //!< Safety margin for receive buffer size -- a value of 3 should make overflows rare in AI state
 #define SYNCBUFFER_SIZE_HIST_LEN 512 //!< Accumulate history over this number of timesteps before updating the sendbuffer size in the absence of overflows
+#define SYNCBUFFER_P2P_INITIAL_CAPACITY 64 //!< Initial size of the per link buffers of the point-to-point exchange
+#define SYNCBUFFER_P2P_TAG 7201 //!< MPI tag of the messages of the point-to-point exchange
+#define SYNCBUFFER_P2P_OVERFLOW_TAG 7202 //!< MPI tag of the resent messages after an overflow in the point-to-point exchange
 
 #include "auryn_definitions.h"
 #include "SpikeDelay.h"
@@ -43,6 +46,10 @@ using namespace std;
  *
  * The class stores the recent history of transmission buffer sizes and tries
  * to determine an optimal size on-line.
+ *
+ * Alternatively the spikes can be exchanged point-to-point (see set_routing). 
+ * Then each rank only sends the spikes of a SpikingGroup to the ranks which 
+ * need them and only communicates with those ranks.
  * */
 
 class SyncBuffer
@@ -71,6 +78,51 @@ class SyncBuffer
 		/*! vector with offset values to allow to pop more than one delay */
 		vector<NeuronID> pop_offsets;
 
+		/*! Send buffer used to signal an overflow. Needs to stay valid while a non-blocking exchange is in flight. */
+		NeuronID overflow_data[2];
+
+#ifdef CODE_USE_NONBLOCKING_SYNC
+		/*! Handle of the pending non-blocking exchange */
+		MPI_Request sync_request;
+#endif
+
+		/*! Is true when spikes are exchanged point-to-point instead of by MPI_Allgather */
+		bool point_to_point;
+
+		/*! Number of SpikingGroups the routing was computed for */
+		unsigned int routing_num_groups;
+
+		/*! Ranks this rank sends spikes to and receives spikes from */
+		vector<int> send_ranks;
+		vector<int> recv_ranks;
+
+		/*! Flags for each send rank and group whether the group is sent to it */
+		vector<char> send_routes;
+
+		/*! Position in send_buf of the data of each group pushed since the last sync and its number of spikes */
+		vector<NeuronID> group_begin;
+		vector<NeuronID> group_spikes;
+
+		/*! Per link buffers and their agreed capacities. The capacities only grow 
+		 * and are updated identically by sender and receiver after an overflow. */
+		vector< vector<NeuronID> > p2p_send_bufs;
+		vector< vector<NeuronID> > p2p_recv_bufs;
+		vector<NeuronID> send_capacities;
+		vector<NeuronID> recv_capacities;
+
+		/*! Send buffers signalling an overflow to each send rank */
+		vector<NeuronID> p2p_overflow_data;
+
+		/*! Handles of the pending point-to-point messages */
+		vector<MPI_Request> p2p_send_requests;
+		vector<MPI_Request> p2p_recv_requests;
+
+		/*! Returns the begin of the data received from the r-th source */
+		NeuronID * get_recv_section(int r);
+
+		void p2p_sync_start();
+		void p2p_sync_finish();
+
 		void reset_send_buffer();
 
 		void init();
@@ -80,11 +132,36 @@ class SyncBuffer
 
 		SyncBuffer( mpi::communicator * com );
 
+		/*! Exchanges all pushed spikes between ranks (blocking). Same as sync_start() followed by sync_finish(). */
 		void sync();
 
+		/*! Starts the exchange of all pushed spikes. Non-blocking when CODE_USE_NONBLOCKING_SYNC is set. 
+		 * The send buffer must not be pushed to before sync_finish() returns. */
+		void sync_start();
+
+		/*! Completes the exchange started by sync_start(). Spikes can be popped afterwards. */
+		void sync_finish();
+
 		void push(SpikeDelay * delay, NeuronID size);
 		void pop(SpikeDelay * delay, NeuronID size);
 
+		/*! \brief Switches to the point-to-point exchange
+		 *
+		 * The tables contain one entry for each rank and SpikingGroup (in order of 
+		 * registration) at position rank*num_groups+group. They have to be the same on all ranks.
+		 * \param evolves Non-zero where the group evolves on the rank, i.e. where its spikes originate
+		 * \param needs Non-zero where the rank needs the spikes of the group */
+		void set_routing(const vector<char> & evolves, const vector<char> & needs, unsigned int num_groups);
+
+		/*! Switches back to the exchange of all spikes by MPI_Allgather */
+		void clear_routing();
+
+		/*! Returns the number of ranks this rank sends spikes to (all ranks without routing) */
+		unsigned int get_num_send_ranks();
+
+		/*! Returns the number of ranks this rank receives spikes from (all ranks without routing) */
+		unsigned int get_num_recv_ranks();
+
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
 		AurynDouble deltaT;
 		AurynDouble measurement_start;
@@ -28,9 +28,16 @@
 void System::init() {
 	clock = 0;
 	quiet = false;
+	num_threads = 1;
+	schedule_valid = false;
+	sync_pending = false;
+	profiling = false;
+	temporal_blocking = false;
+	point_to_point_sync = false;
 	set_simulation_name("default");
 
 	syncbuffer = new SyncBuffer(mpicom);
+	profiler = new Profiler();
 
 	stringstream oss;
 	oss.str("");
@@ -56,6 +63,10 @@ void System::init() {
 		<< std::numeric_limits<NeuronID>::max()/MINDELAY << " cells.";
 	logger->msg(oss.str(),DEBUG);
 
+	oss.str("");
+	oss << "Using " << auryn_get_simd_level_name() << " vector operations.";
+	logger->msg(oss.str(),NOTIFICATION);
+
 }
 
 System::System()
@@ -108,6 +119,7 @@ void System::free()
 	checkers.clear();
 
 	delete syncbuffer;
+	delete profiler;
 }
 
 void System::step()
@@ -164,11 +176,13 @@ void System::register_spiking_group(SpikingGroup * spiking_group)
 {
 	spiking_groups.push_back(spiking_group);
 	spiking_group->set_clock_ptr(get_clock_ptr());
+	schedule_valid = false;
 }
 
 void System::register_connection(Connection * connection)
 {
 	connections.push_back(connection);
+	schedule_valid = false;
 }
 
 void System::register_monitor(Monitor * monitor)
@@ -181,8 +195,547 @@ void System::register_checker(Checker * checker)
 	checkers.push_back(checker);
 }
 
+void System::set_num_threads(int n)
+{
+	stringstream oss;
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	if ( n < 1 ) n = 1;
+	num_threads = n;
+	oss << "Using " << num_threads << " threads on this rank.";
+	logger->msg(oss.str(),NOTIFICATION);
+#else
+	oss << "Compiled without OpenMP support. Ignoring request for " 
+		<< n << " threads.";
+	logger->msg(oss.str(),WARNING);
+#endif
+}
+
+int System::get_num_threads()
+{
+	return num_threads;
+}
+
+void System::set_profiling(bool enable, string filename)
+{
+	profiling = enable;
+	profiler_filename = filename;
+}
+
+void System::set_temporal_blocking(bool enable)
+{
+	temporal_blocking = enable;
+}
+
+void System::set_point_to_point_sync(bool enable)
+{
+	point_to_point_sync = enable;
+}
+
+/*! Orders nodes by their degree for reverse_cuthill_mckee */
+struct DegreeLess 
+{
+	const vector<AurynLong> * degree;
+	bool operator()(NeuronID a, NeuronID b) const { return (*degree)[a] < (*degree)[b]; }
+};
+
+/*! Computes the reverse Cuthill-McKee order of a symmetric graph with n nodes
+ * whose neighbours are stored in adj[ptr[i]] to adj[ptr[i+1]-1]. 
+ * order[k] is the node which is moved to position k. */
+static void reverse_cuthill_mckee(NeuronID n, const vector<AurynLong> & ptr, const vector<NeuronID> & adj, vector<NeuronID> & order)
+{
+	vector<AurynLong> degree(n);
+	for ( NeuronID i = 0 ; i < n ; ++i ) 
+		degree[i] = ptr[i+1]-ptr[i];
+	DegreeLess less;
+	less.degree = &degree;
+
+	// each component is started from its node with the lowest degree
+	vector<NeuronID> start(n);
+	for ( NeuronID i = 0 ; i < n ; ++i ) 
+		start[i] = i;
+	std::stable_sort(start.begin(), start.end(), less);
+
+	vector<char> visited(n,0);
+	order.clear();
+	order.reserve(n);
+	for ( NeuronID s = 0 ; s < n ; ++s ) {
+		if ( visited[start[s]] ) continue;
+		visited[start[s]] = 1;
+		order.push_back(start[s]);
+		// breadth first search which appends the neighbours by increasing degree
+		for ( AurynLong head = order.size()-1 ; head < order.size() ; ++head ) {
+			const NeuronID v = order[head];
+			const AurynLong first = order.size();
+			for ( AurynLong k = ptr[v] ; k < ptr[v+1] ; ++k ) {
+				if ( !visited[adj[k]] ) {
+					visited[adj[k]] = 1;
+					order.push_back(adj[k]);
+				}
+			}
+			std::stable_sort(order.begin()+first, order.end(), less);
+		}
+	}
+	std::reverse(order.begin(), order.end());
+}
+
+void System::reorder_neurons()
+{
+	if ( get_clock() > 0 ) {
+		logger->msg("System:: Neurons can only be reordered before the first run.",ERROR);
+		return;
+	}
+
+	for ( unsigned int g = 0 ; g < spiking_groups.size() ; ++g ) {
+		SpikingGroup * group = spiking_groups[g];
+
+		// all connections from and to the group have to support renumbering
+		int local_ok = 1;
+		for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+			if ( ( connections[i]->get_source() == group || connections[i]->get_destination() == group ) 
+					&& !connections[i]->allows_neuron_permutation() ) 
+				local_ok = 0;
+		}
+		int ok;
+		all_reduce(*mpicom, local_ok, ok, mpi::minimum<int>());
+		if ( !ok ) {
+			stringstream oss;
+			oss << "System:: Not reordering " << group->get_name() 
+				<< " because one of its Connections does not support it.";
+			logger->msg(oss.str(),WARNING);
+			continue;
+		}
+
+		// only groups with recurrent connections are reordered
+		int local_recurrent = 0;
+		for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+			if ( connections[i]->get_source() == group && connections[i]->get_destination() == group ) 
+				local_recurrent = 1;
+		}
+		int recurrent;
+		all_reduce(*mpicom, local_recurrent, recurrent, mpi::maximum<int>());
+		if ( !recurrent ) continue;
+
+		// symmetric graph of the recurrent synapses between the neurons on this rank
+		const NeuronID n = group->get_rank_size();
+		vector<NeuronID> edges;
+		for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+			if ( connections[i]->get_source() != group || connections[i]->get_destination() != group ) continue;
+			vector<neuron_pair> block = connections[i]->get_block(0, group->get_size(), 0, group->get_size());
+			for ( AurynLong k = 0 ; k < block.size() ; ++k ) {
+				if ( block[k].i != block[k].j && group->localrank(block[k].i) ) {
+					edges.push_back(group->global2rank(block[k].i));
+					edges.push_back(group->global2rank(block[k].j));
+				}
+			}
+		}
+		vector<AurynLong> ptr(n+1,0);
+		for ( AurynLong k = 0 ; k < edges.size() ; ++k ) 
+			ptr[edges[k]+1]++;
+		for ( NeuronID i = 0 ; i < n ; ++i ) 
+			ptr[i+1] += ptr[i];
+		vector<NeuronID> adj(edges.size());
+		vector<AurynLong> next(ptr.begin(), ptr.end()-1);
+		for ( AurynLong k = 0 ; k < edges.size() ; k += 2 ) {
+			adj[next[edges[k]]++] = edges[k+1];
+			adj[next[edges[k+1]]++] = edges[k];
+		}
+
+		vector<NeuronID> order;
+		reverse_cuthill_mckee(n, ptr, adj, order);
+		vector<NeuronID> local_ids(n);
+		for ( NeuronID k = 0 ; k < n ; ++k ) 
+			local_ids[order[k]] = k;
+
+		// neuron x on rank r has the id x*locked_range+r-locked_rank
+		vector< vector<NeuronID> > all_ids;
+		mpi::all_gather(*mpicom, local_ids, all_ids);
+		const NeuronID range = group->get_locked_range();
+		vector<NeuronID> new_ids(group->get_size());
+		bool identity = true;
+		for ( unsigned int r = group->get_locked_rank() ; r < group->get_locked_rank()+range ; ++r ) {
+			const NeuronID shift = r-group->get_locked_rank();
+			for ( NeuronID x = 0 ; x < all_ids[r].size() ; ++x ) {
+				new_ids[x*range+shift] = all_ids[r][x]*range+shift;
+				if ( all_ids[r][x] != x ) identity = false;
+			}
+		}
+		if ( identity ) continue;
+
+		group->permute_neurons(new_ids);
+		for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+			const vector<NeuronID> * pre_ids = ( connections[i]->get_source() == group ) ? &new_ids : NULL;
+			const vector<NeuronID> * post_ids = ( connections[i]->get_destination() == group ) ? &new_ids : NULL;
+			if ( pre_ids || post_ids ) 
+				connections[i]->permute_neurons(pre_ids, post_ids);
+		}
+		for ( unsigned int i = 0 ; i < monitors.size() ; ++i ) 
+			monitors[i]->permute_neurons(group, new_ids);
+
+		stringstream oss;
+		oss << "System:: Reordered the neurons of " << group->get_name() 
+			<< " (reverse Cuthill-McKee).";
+		logger->msg(oss.str(),NOTIFICATION);
+	}
+}
+
+void System::build_sync_routing()
+{
+	if ( !point_to_point_sync ) {
+		syncbuffer->clear_routing();
+		return;
+	}
+
+	const unsigned int num_groups = spiking_groups.size();
+	map<SpikingGroup *, unsigned int> group_index;
+	for ( unsigned int i = 0 ; i < num_groups ; ++i ) 
+		group_index[spiking_groups[i]] = i;
+
+	// a rank needs the spikes of the groups it evolves and of those projecting to it
+	vector<char> local(2*num_groups,0);
+	for ( unsigned int i = 0 ; i < num_groups ; ++i ) {
+		local[2*i] = spiking_groups[i]->evolve_locally();
+		local[2*i+1] = spiking_groups[i]->evolve_locally();
+	}
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+		map<SpikingGroup *, unsigned int>::iterator it = group_index.find(connections[i]->get_source());
+		if ( it != group_index.end() && connections[i]->get_destination()->evolve_locally() ) 
+			local[2*it->second+1] = 1;
+	}
+
+	vector< vector<char> > all;
+	mpi::all_gather(*mpicom, local, all);
+
+	vector<char> evolves(mpicom->size()*num_groups);
+	vector<char> needs(mpicom->size()*num_groups);
+	for ( int r = 0 ; r < mpicom->size() ; ++r ) {
+		for ( unsigned int i = 0 ; i < num_groups ; ++i ) {
+			evolves[r*num_groups+i] = all[r][2*i];
+			needs[r*num_groups+i] = all[r][2*i+1];
+		}
+	}
+	syncbuffer->set_routing(evolves, needs, num_groups);
+
+	stringstream oss;
+	oss << "Point-to-point sync sends spikes to "
+		<< syncbuffer->get_num_send_ranks() 
+		<< " and receives spikes from "
+		<< syncbuffer->get_num_recv_ranks()
+		<< " of " << mpicom->size() << " ranks.";
+	logger->msg(oss.str(),NOTIFICATION);
+}
+
+bool System::build_block_schedule()
+{
+	string reason;
+	if ( num_threads > 1 ) 
+		reason = "multiple threads are used";
+
+	map<SpikingGroup *, unsigned int> group_index;
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i ) 
+		group_index[spiking_groups[i]] = i;
+
+	block_connections.assign(spiking_groups.size(), vector<unsigned int>());
+	for ( unsigned int i = 0 ; i < connections.size() && reason.empty() ; ++i ) {
+		map<SpikingGroup *, unsigned int>::iterator it = group_index.find(connections[i]->get_destination());
+		if ( !connections[i]->allows_temporal_blocking() || it == group_index.end() ) 
+			reason = "Connection "+connections[i]->get_name()+" does not support it";
+		else 
+			block_connections[it->second].push_back(i);
+	}
+
+	block_checkers.assign(spiking_groups.size(), vector<unsigned int>());
+	for ( unsigned int i = 0 ; i < checkers.size() && reason.empty() ; ++i ) {
+		map<SpikingGroup *, unsigned int>::iterator it = group_index.find(checkers[i]->get_source());
+		if ( it == group_index.end() ) 
+			reason = "a Checker is not watching a registered group";
+		else 
+			block_checkers[it->second].push_back(i);
+	}
+
+	block_monitors.assign(spiking_groups.size(), vector<unsigned int>());
+	for ( unsigned int i = 0 ; i < monitors.size() && reason.empty() ; ++i ) {
+		map<SpikingGroup *, unsigned int>::iterator it = group_index.find(monitors[i]->get_source());
+		if ( it == group_index.end() ) 
+			reason = "Monitor "+monitors[i]->get_filename()+" does not record from a single group";
+		else 
+			block_monitors[it->second].push_back(i);
+	}
+
+	if ( !reason.empty() ) {
+		logger->msg("Temporal blocking disabled because "+reason+".",WARNING);
+		return false;
+	}
+
+	// groups run up to MINDELAY steps ahead of the Connections reading from them
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i ) 
+		spiking_groups[i]->delay->set_block_length(MINDELAY);
+
+	logger->msg("Using temporal blocking.",NOTIFICATION);
+	return true;
+}
+
+bool System::run_block(bool checking)
+{
+	// all spikes delivered in this block have been emitted before
+	sync_finish();
+
+	const AurynTime block_start = clock;
+	for ( unsigned int g = 0 ; g < spiking_groups.size() ; ++g ) {
+		for ( clock = block_start ; clock < block_start+MINDELAY ; ++clock ) {
+			evolve_group(g);
+
+			for ( unsigned int k = 0 ; k < block_connections[g].size() ; ++k ) 
+				propagate_connection(block_connections[g][k]);
+
+			for ( unsigned int k = 0 ; k < block_monitors[g].size() ; ++k ) 
+				propagate_monitor(block_monitors[g][k]);
+
+			for ( unsigned int k = 0 ; k < block_checkers[g].size() ; ++k ) {
+				unsigned int i = block_checkers[g][k];
+				if (!checkers[i]->propagate() && checking) {
+					stringstream oss;
+					oss << "Checker " << i << " broke run!";
+					logger->msg(oss.str(),WARNING);
+					return false;
+				}
+			}
+
+			evolve_group_traces(g);
+
+			for ( unsigned int k = 0 ; k < block_connections[g].size() ; ++k ) 
+				evolve_connection(block_connections[g][k]);
+		}
+	}
+	clock = block_start+MINDELAY;
+
+	if ( mpicom->size()>1 ) {
+#ifdef CODE_USE_NONBLOCKING_SYNC
+		sync_start();
+#else
+		sync();
+#endif
+	} 
+
+	return true;
+}
+
+void System::save_load_profile(string filename)
+{
+	const int n = spiking_groups.size();
+	if ( !profiling || profiler->get_size() == 0 || n == 0 ) {
+		logger->msg("Can't save load profile without a profiled run",ERROR);
+		return;
+	}
+
+	map<SpikingGroup *, unsigned int> group_index;
+	vector<AurynDouble> local_loads(n);
+	for ( int i = 0 ; i < n ; ++i ) {
+		group_index[spiking_groups[i]] = i;
+		local_loads[i] = profiler->get_time(profiler_offset_groups+i)
+			+ profiler->get_time(profiler_offset_traces+i);
+	}
+
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+		map<SpikingGroup *, unsigned int>::iterator it = group_index.find(connections[i]->get_destination());
+		if ( it == group_index.end() ) continue;
+		local_loads[it->second] += profiler->get_time(profiler_offset_connections+i)
+			+ profiler->get_time(profiler_offset_connections+connections.size()+i);
+	}
+
+	vector<AurynDouble> loads(n);
+	all_reduce(*mpicom, &local_loads[0], n, &loads[0], std::plus<AurynDouble>());
+
+	AurynDouble rank_load = 0.0;
+	for ( int i = 0 ; i < n ; ++i ) 
+		rank_load += local_loads[i];
+
+	vector<AurynDouble> rank_loads;
+	gather(*mpicom, rank_load, rank_loads, 0);
+
+	if ( mpicom->rank() != 0 ) return;
+
+	AurynDouble mean = 0.0;
+	AurynDouble maximum = 0.0;
+	for ( unsigned int r = 0 ; r < rank_loads.size() ; ++r ) {
+		mean += rank_loads[r]/rank_loads.size();
+		maximum = max(maximum,rank_loads[r]);
+	}
+
+	stringstream oss;
+	oss << "Measured load imbalance between ranks (max/mean) " << maximum/mean;
+	logger->msg(oss.str(),NOTIFICATION);
+
+	ofstream outfile;
+	outfile.open(filename.c_str(),ios::out);
+	if (!outfile) {
+		oss.str("");
+		oss << "Can't open load profile file " << filename;
+		logger->msg(oss.str(),ERROR);
+		return;
+	}
+
+	outfile << "# size load name" << endl;
+	for ( int i = 0 ; i < n ; ++i ) {
+		string name = spiking_groups[i]->get_name();
+		replace(name.begin(), name.end(), ' ', '_');
+		outfile << spiking_groups[i]->get_size() << " " 
+			<< loads[i] << " " 
+			<< name << endl;
+	}
+	outfile.close();
+
+	oss.str("");
+	oss << "Load profile written to " << filename;
+	logger->msg(oss.str(),NOTIFICATION);
+}
+
+void System::load_load_profile(string filename)
+{
+	vector<NeuronID> sizes;
+	vector<double> loads;
+
+	if ( mpicom->rank() == 0 ) {
+		ifstream infile(filename.c_str());
+		if (!infile) {
+			stringstream oss;
+			oss << "Can't open load profile file " << filename;
+			logger->msg(oss.str(),ERROR);
+		} else {
+			string line;
+			while ( getline(infile,line) ) {
+				if ( line.empty() || line[0] == '#' ) continue;
+				stringstream iss(line);
+				NeuronID size;
+				double load;
+				if ( iss >> size >> load ) {
+					sizes.push_back(size);
+					loads.push_back(load);
+				}
+			}
+			infile.close();
+		}
+	}
+
+	broadcast(*mpicom, sizes, 0);
+	broadcast(*mpicom, loads, 0);
+
+	double total = 0.0;
+	for ( unsigned int i = 0 ; i < loads.size() ; ++i ) 
+		total += loads[i];
+
+	if ( total <= 0.0 ) {
+		logger->msg("Load profile is empty. Keeping the default distribution.",WARNING);
+		return;
+	}
+
+	vector<double> shares(loads.size());
+	for ( unsigned int i = 0 ; i < loads.size() ; ++i ) 
+		shares[i] = loads[i]/total;
+
+	SpikingGroup::set_load_profile(sizes, shares);
+
+	stringstream oss;
+	oss << "Loaded load profile for " << shares.size() << " SpikingGroups from " << filename;
+	logger->msg(oss.str(),NOTIFICATION);
+}
+
+void System::setup_profiler()
+{
+	profiler->clear();
+
+	profiler_offset_groups = profiler->get_size();
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i )
+		profiler->add_entry("evolve", spiking_groups[i]->get_name());
+
+	profiler_offset_traces = profiler->get_size();
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i )
+		profiler->add_entry("traces", spiking_groups[i]->get_name());
+
+	profiler_offset_connections = profiler->get_size();
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i )
+		profiler->add_entry("propagate", connections[i]->get_name());
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i )
+		profiler->add_entry("plasticity", connections[i]->get_name());
+
+	profiler_offset_monitors = profiler->get_size();
+	for ( unsigned int i = 0 ; i < monitors.size() ; ++i )
+		profiler->add_entry("monitor", monitors[i]->get_filename(), false);
+
+	profiler_offset_sync = profiler->get_size();
+	profiler->add_entry("sync_start", "SyncBuffer");
+	profiler->add_entry("sync_finish", "SyncBuffer");
+
+	profiler->reset();
+}
+
+void System::build_schedule()
+{
+	serial_groups.clear();
+	concurrent_groups.clear();
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i ) {
+		if ( spiking_groups[i]->evolve_concurrently() ) 
+			concurrent_groups.push_back(i);
+		else
+			serial_groups.push_back(i);
+	}
+
+	// Connections which write to the same group are joined (union-find) 
+	// into one task. Each connection writes to its destination and, when 
+	// spike attributes are used (e.g. STPConnection), also to its source.
+	vector<unsigned int> parent(connections.size());
+	map<SpikingGroup *, unsigned int> owner;
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+		parent[i] = i;
+		SpikingGroup * keys[2];
+		keys[0] = connections[i]->get_destination();
+		keys[1] = connections[i]->get_source();
+		int nkeys = ( keys[1] != NULL && keys[1]->get_num_spike_attributes() ) ? 2 : 1;
+		for ( int k = 0 ; k < nkeys ; ++k ) {
+			map<SpikingGroup *, unsigned int>::iterator it = owner.find(keys[k]);
+			if ( it == owner.end() ) {
+				owner[keys[k]] = i;
+			} else {
+				unsigned int a = it->second;
+				while ( parent[a] != a ) a = parent[a];
+				unsigned int b = i;
+				while ( parent[b] != b ) b = parent[b];
+				parent[max(a,b)] = min(a,b);
+			}
+		}
+	}
+
+	propagation_tasks.clear();
+	map<unsigned int, unsigned int> task_of_root;
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) {
+		unsigned int root = i;
+		while ( parent[root] != root ) root = parent[root];
+		if ( task_of_root.find(root) == task_of_root.end() ) {
+			task_of_root[root] = propagation_tasks.size();
+			propagation_tasks.push_back(vector<unsigned int>());
+		}
+		propagation_tasks[task_of_root[root]].push_back(i);
+	}
+
+	stringstream oss;
+	oss << "Schedule: " << concurrent_groups.size() << " concurrent and " 
+		<< serial_groups.size() << " serial groups, " 
+		<< propagation_tasks.size() << " propagation tasks for "
+		<< connections.size() << " connections.";
+	logger->msg(oss.str(),DEBUG);
+
+	schedule_valid = true;
+}
+
 void System::sync()
 {
+	sync_start();
+	sync_finish();
+}
+
+void System::sync_start()
+{
+	AurynDouble t0 = 0.0;
+	if ( profiling ) t0 = Profiler::get_wall_time();
 
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
 	double T1, T2;              
@@ -199,10 +752,40 @@ void System::sync()
 	// tim.tv_nsec = 500000L;
 	// nanosleep(&tim,&tim2);
 	
-	syncbuffer->sync();
+	syncbuffer->sync_start();
+	sync_pending = true;
+
+	if ( profiling ) 
+		profiler->add(profiler_offset_sync, Profiler::get_wall_time()-t0);
+
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+    T2 = MPI_Wtime();     /* end time */
+	deltaT += (T2-T1);
+#endif
+}
+
+void System::sync_finish()
+{
+	if ( !sync_pending ) return;
+
+	AurynDouble t0 = 0.0;
+	if ( profiling ) t0 = Profiler::get_wall_time();
+
+#ifdef CODE_COLLECT_SYNC_TIMING_STATS
+	double T1, T2;              
+    T1 = MPI_Wtime();     /* start time */
+#endif
+
+	syncbuffer->sync_finish();
+	sync_pending = false;
+
+	vector<SpikingGroup *>::const_iterator iter;
 	for ( iter = spiking_groups.begin() ; iter != spiking_groups.end() ; ++iter ) 
 		syncbuffer->pop((*iter)->delay,(*iter)->get_size()); 
 
+	if ( profiling ) 
+		profiler->add(profiler_offset_sync+1, Profiler::get_wall_time()-t0);
+
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
     T2 = MPI_Wtime();     /* end time */
 	deltaT += (T2-T1);
@@ -211,37 +794,147 @@ void System::sync()
 
 void System::evolve()
 {
-	vector<SpikingGroup *>::const_iterator iter;
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	if ( num_threads > 1 ) {
+		if ( !schedule_valid ) build_schedule();
+
+		for ( unsigned int i = 0 ; i < serial_groups.size() ; ++i )
+			evolve_group(serial_groups[i]);
+
+		const int n = concurrent_groups.size();
+		#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+		for ( int i = 0 ; i < n ; ++i )
+			evolve_group(concurrent_groups[i]);
+		return;
+	}
+#endif
 
-	for ( iter = spiking_groups.begin() ; iter != spiking_groups.end() ; ++iter ) 
-		(*iter)->conditional_evolve(); // evolve only if existing on rank
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i ) 
+		evolve_group(i); // evolve only if existing on rank
 }
 
 void System::evolve_independent()
 {
-	for ( vector<SpikingGroup *>::const_iterator iter = spiking_groups.begin() ; 
-		  iter != spiking_groups.end() ; 
-		  ++iter ) 
-		(*iter)->evolve_traces(); // evolve only if existing on rank
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	if ( num_threads > 1 ) {
+		const int ngroups = spiking_groups.size();
+		#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+		for ( int i = 0 ; i < ngroups ; ++i )
+			evolve_group_traces(i); 
+
+		const int ncons = connections.size();
+		#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+		for ( int i = 0 ; i < ncons ; ++i )
+			evolve_connection(i); 
+		return;
+	}
+#endif
+
+	for ( unsigned int i = 0 ; i < spiking_groups.size() ; ++i ) 
+		evolve_group_traces(i); // evolve only if existing on rank
 
-	for ( vector<Connection *>::const_iterator iter = connections.begin() ; 
-			iter != connections.end() ; 
-			++iter )
-		(*iter)->evolve(); 
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) 
+		evolve_connection(i); 
 }
 
 void System::propagate()
 {
-	vector<Connection *>::const_iterator iter;
-	for ( iter = connections.begin() ; iter != connections.end() ; ++iter )
-		(*iter)->propagate(); 
+#ifdef CODE_ACTIVATE_OPENMP_THREADS
+	if ( num_threads > 1 ) {
+		if ( !schedule_valid ) build_schedule();
+
+		const int n = propagation_tasks.size();
+		#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+		for ( int i = 0 ; i < n ; ++i ) {
+			for ( unsigned int k = 0 ; k < propagation_tasks[i].size() ; ++k ) 
+				propagate_connection(propagation_tasks[i][k]); 
+		}
+		return;
+	}
+#endif
+
+	for ( unsigned int i = 0 ; i < connections.size() ; ++i ) 
+		propagate_connection(i); 
+}
+
+void System::evolve_group(unsigned int i)
+{
+	SpikingGroup * group = spiking_groups[i];
+	if ( !profiling ) {
+		group->conditional_evolve();
+		return;
+	}
+
+	AurynDouble t0 = Profiler::get_wall_time();
+	group->conditional_evolve();
+	profiler->add(profiler_offset_groups+i, Profiler::get_wall_time()-t0, group->get_spikes_immediate()->size());
+}
+
+void System::evolve_group_traces(unsigned int i)
+{
+	SpikingGroup * group = spiking_groups[i];
+	if ( !profiling ) {
+		group->evolve_traces();
+		return;
+	}
+
+	AurynDouble t0 = Profiler::get_wall_time();
+	group->evolve_traces();
+	profiler->add(profiler_offset_traces+i, Profiler::get_wall_time()-t0);
+}
+
+void System::propagate_connection(unsigned int i)
+{
+	Connection * con = connections[i];
+	if ( !profiling ) {
+		con->propagate();
+		return;
+	}
+
+	AurynDouble t0 = Profiler::get_wall_time();
+	con->propagate();
+	AurynDouble t = Profiler::get_wall_time()-t0;
+
+	// Synapses touched are estimated from the presynaptic spikes and the mean row length
+	AurynLong nspikes = 0;
+	AurynLong nsynapses = 0;
+	if ( con->get_source() != NULL ) {
+		nspikes = con->get_source()->get_spikes()->size();
+		if ( con->get_m_rows() ) 
+			nsynapses = nspikes*con->get_nonzero()/con->get_m_rows();
+	}
+	profiler->add(profiler_offset_connections+i, t, nspikes, nsynapses);
+}
+
+void System::evolve_connection(unsigned int i)
+{
+	Connection * con = connections[i];
+	if ( !profiling ) {
+		con->evolve();
+		return;
+	}
+
+	AurynDouble t0 = Profiler::get_wall_time();
+	con->evolve();
+	profiler->add(profiler_offset_connections+connections.size()+i, Profiler::get_wall_time()-t0);
+}
+
+void System::propagate_monitor(unsigned int i)
+{
+	if ( !profiling ) {
+		monitors[i]->propagate();
+		return;
+	}
+
+	AurynDouble t0 = Profiler::get_wall_time();
+	monitors[i]->propagate();
+	profiler->add(profiler_offset_monitors+i, Profiler::get_wall_time()-t0);
 }
 
 bool System::monitor(bool checking)
 {
-	vector<Monitor *>::const_iterator iter;
-	for ( iter = monitors.begin() ; iter != monitors.end() ; ++iter )
-		(*iter)->propagate();
+	for ( unsigned int i = 0 ; i < monitors.size() ; ++i ) 
+		propagate_monitor(i);
 
 	for ( unsigned int i = 0 ; i < checkers.size() ; ++i )
 		if (!checkers[i]->propagate() && checking) {
@@ -344,15 +1037,31 @@ bool System::run(AurynTime starttime, AurynTime stoptime, AurynFloat total_time,
 	syncbuffer->reset_sync_time();
 #endif
 
+	// connections might have been rewired since the last run
+	if ( num_threads > 1 ) build_schedule();
+
+	if ( profiling ) setup_profiler();
+
+	const bool blocking = temporal_blocking && build_block_schedule();
+
+	if ( mpicom->size()>1 ) build_sync_routing();
+
 	time_t t_sim_start;
 	time(&t_sim_start);
 	time_t t_last_mark = t_sim_start;
 
 	while ( get_clock() < stoptime ) {
 
-	    if ( (mpicom->rank()==0) && (not quiet) && ( (get_clock()%PROGRESSBAR_UPDATE_INTERVAL==0) || get_clock()==(stoptime-1) ) ) {
-			double fraction = 1.0*(get_clock()-starttime+1)*dt/total_time;
-			progressbar(fraction,get_clock()); // TODO find neat solution for the rate
+		// number of steps integrated in this iteration
+		AurynTime steps = 1;
+		if ( blocking && get_clock()%MINDELAY == 0 && get_clock()+MINDELAY <= stoptime ) 
+			steps = MINDELAY;
+		const AurynTime last_step = get_clock()+steps-1;
+
+	    if ( (mpicom->rank()==0) && (not quiet) && ( (get_clock()%PROGRESSBAR_UPDATE_INTERVAL==0) || last_step==(stoptime-1) ) ) {
+			AurynTime clk = ( last_step==(stoptime-1) ) ? last_step : get_clock();
+			double fraction = 1.0*(clk-starttime+1)*dt/total_time;
+			progressbar(fraction,clk); // TODO find neat solution for the rate
 		}
 
 		if ( get_clock()%LOGGER_MARK_INTERVAL==0 ) // set a mark 
@@ -379,7 +1088,18 @@ bool System::run(AurynTime starttime, AurynTime stoptime, AurynFloat total_time,
 			logger->msg(oss.str(),NOTIFICATION);
 		}
 
+		if ( steps > 1 ) {
+			if ( !run_block(checking) )
+				return false;
+			continue;
+		}
+
 		evolve();
+
+		// Spikes received in the last sync are needed from here on. With 
+		// CODE_USE_NONBLOCKING_SYNC the exchange overlapped with evolve().
+		sync_finish();
+
 		propagate();
 
 		if (!monitor(checking))
@@ -393,11 +1113,18 @@ bool System::run(AurynTime starttime, AurynTime stoptime, AurynFloat total_time,
 		step();	
 
 		if ( mpicom->size()>1 && (get_clock())%(MINDELAY) == 0 ) {
+#ifdef CODE_USE_NONBLOCKING_SYNC
+			sync_start();
+#else
 			sync();
+#endif
 		} 
 
 	}
 
+	// leave the SpikeDelays in a consistent state after the run 
+	sync_finish();
+
 
 
 #ifdef CODE_COLLECT_SYNC_TIMING_STATS
@@ -452,6 +1179,8 @@ bool System::run(AurynTime starttime, AurynTime stoptime, AurynFloat total_time,
 	}
 #endif 
 
+	if ( profiling ) 
+		profiler->report(mpicom, profiler_filename);
 
 	return true;
 }
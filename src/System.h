@@ -32,10 +32,13 @@
 #include "Monitor.h"
 #include "Checker.h"
 #include "SyncBuffer.h"
+#include "Profiler.h"
 
 #include <ctime>
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <boost/mpi.hpp>
 #include <boost/progress.hpp>
 
@@ -67,6 +70,92 @@ private:
 
 	double simulation_time_realtime_ratio;
 
+	/*! Number of threads used for evolve and propagate on this rank */
+	int num_threads;
+
+	/*! Is false whenever objects were registered after the last call of build_schedule() */
+	bool schedule_valid;
+
+	/*! Indices of SpikingGroups which are evolved serially in order of registration
+	 * because they share state with other groups. */
+	vector<unsigned int> serial_groups;
+
+	/*! Indices of SpikingGroups which can be evolved concurrently. */
+	vector<unsigned int> concurrent_groups;
+
+	/*! Connections bundled into tasks which can be propagated concurrently.
+	 * Connections that share a destination NeuronGroup (or a source whose 
+	 * spike attributes they write) end up in the same task and are processed
+	 * in order of registration. This keeps the results independent of the
+	 * number of threads. */
+	vector< vector<unsigned int> > propagation_tasks;
+
+	/*! Sorts registered objects into serial_groups, concurrent_groups and propagation_tasks. */
+	void build_schedule();
+
+	/*! Is true between sync_start() and sync_finish() */
+	bool sync_pending;
+
+	/*! Toggles the collection of per-object timing statistics during run() */
+	bool profiling;
+
+	/*! File to which the profile is written at the end of each run (if not empty) */
+	string profiler_filename;
+
+	Profiler * profiler;
+
+	/*! Offsets of the different phases in the profiler entries */
+	unsigned int profiler_offset_groups;
+	unsigned int profiler_offset_traces;
+	unsigned int profiler_offset_connections;
+	unsigned int profiler_offset_monitors;
+	unsigned int profiler_offset_sync;
+
+	/*! Creates one profiler entry per registered object and phase */
+	void setup_profiler();
+
+	/*! Evolves SpikingGroup i (and profiles it if enabled) */
+	void evolve_group(unsigned int i);
+
+	/*! Evolves the traces of SpikingGroup i (and profiles it if enabled) */
+	void evolve_group_traces(unsigned int i);
+
+	/*! Propagates Connection i (and profiles it if enabled) */
+	void propagate_connection(unsigned int i);
+
+	/*! Evolves Connection i (and profiles it if enabled) */
+	void evolve_connection(unsigned int i);
+
+	/*! Propagates Monitor i (and profiles it if enabled) */
+	void propagate_monitor(unsigned int i);
+
+	/*! Toggles temporal blocking (see set_temporal_blocking) */
+	bool temporal_blocking;
+
+	/*! Indices of the Connections targeting each SpikingGroup in order of registration */
+	vector< vector<unsigned int> > block_connections;
+
+	/*! Indices of the Checkers watching each SpikingGroup */
+	vector< vector<unsigned int> > block_checkers;
+
+	/*! Indices of the Monitors recording from each SpikingGroup */
+	vector< vector<unsigned int> > block_monitors;
+
+	/*! Checks whether temporal blocking can be used with the registered objects 
+	 * and sets up block_connections, block_checkers and block_monitors if so. */
+	bool build_block_schedule();
+
+	/*! Integrates MINDELAY time steps group by group and advances the clock accordingly.
+	 * Returns false if a Checker broke the run. */
+	bool run_block(bool checking);
+
+	/*! Toggles the point-to-point spike exchange (see set_point_to_point_sync) */
+	bool point_to_point_sync;
+
+	/*! Determines which ranks need the spikes of each SpikingGroup and 
+	 * configures the SyncBuffer accordingly. Collective call. */
+	void build_sync_routing();
+
 	/*! Returns string with a human readable time. */
 	string get_nice_time ( AurynTime clk );	
 
@@ -104,6 +193,13 @@ public:
 	/*! Synchronizes SpikingGroups */
 	void sync();
 
+	/*! Pushes the spikes of all SpikingGroups to the SyncBuffer and starts the exchange between ranks. */
+	void sync_start();
+
+	/*! Completes a sync started with sync_start() and pops the received spikes into the SpikeDelays. 
+	 * Does nothing if there is no pending sync. */
+	void sync_finish();
+
 	/*! Evolves all objects that need integration. */
 	void evolve();
 
@@ -127,6 +223,88 @@ public:
 	/*! Registers an instance of Monitor to the monitors vector. */
 	void register_monitor(Monitor * monitor);
 
+	/*! Sets the number of threads used to evolve SpikingGroups and to 
+	 * propagate Connections on this rank. Defaults to one. Only has an
+	 * effect when Auryn was compiled with OpenMP support. */
+	void set_num_threads(int n);
+
+	/*! Returns the number of threads used on this rank */
+	int get_num_threads();
+
+	/*! Toggles the profiler. When enabled the wall time, the number of calls 
+	 * and the processed spikes of each registered SpikingGroup, Connection
+	 * and Monitor as well as of the sync are recorded during run(). 
+	 * At the end of each run the statistics are reduced across ranks and 
+	 * printed as a table ranked by time. 
+	 * \param enable Switches profiling on or off
+	 * \param filename If not empty rank 0 additionally writes the profile to this file */
+	void set_profiling(bool enable, string filename="");
+
+	/*! Toggles temporal blocking. Since spikes are delayed by at least MINDELAY
+	 * time steps, the SpikingGroups do not depend on each other within blocks 
+	 * of MINDELAY steps. With temporal blocking run() integrates each group 
+	 * together with its incoming Connections for a whole block before moving
+	 * on to the next group, which keeps the state of the group in cache. 
+	 * Results are the same as for step-by-step integration unless groups 
+	 * share a random number generator (e.g. PoissonGroup).
+	 *
+	 * Temporal blocking is only used when all Connections support it 
+	 * (Connection::allows_temporal_blocking, i.e. no plasticity or short-term
+	 * plasticity), all Monitors record from a single group 
+	 * (Monitor::get_source) and a single thread is used.
+	 * Otherwise run() falls back to step-by-step integration. */
+	void set_temporal_blocking(bool enable);
+
+	/*! Toggles the point-to-point spike exchange. Instead of sending all 
+	 * spikes to all ranks with MPI_Allgather, the spikes of a SpikingGroup 
+	 * are only sent to the ranks on which the group evolves or on which a 
+	 * Connection from the group to a local NeuronGroup exists. The routes
+	 * are computed at the beginning of each run. This reduces the 
+	 * communication when groups have targets on few ranks only (e.g. with 
+	 * rank locked groups). 
+	 *
+	 * Monitors which read the delayed spikes of a group on ranks on which 
+	 * the group neither evolves nor projects to (DelayedSpikeMonitor) do 
+	 * not see its spikes in this mode. Has to be called on all ranks. */
+	void set_point_to_point_sync(bool enable);
+
+	/*! \brief Renumbers the neurons of each group to improve memory locality
+	 *
+	 * Computes a reverse Cuthill-McKee order of the neurons of each group on 
+	 * each rank from the recurrent Connections of the group, such that 
+	 * neurons which are connected to each other get close ids. The neurons 
+	 * only change places within their rank. The state vectors of the groups 
+	 * and the weight matrices of all Connections from and to the group are 
+	 * permuted consistently, which reduces cache misses in propagate and in 
+	 * the backward propagation of plastic connections for structured (e.g. 
+	 * assembly) connectivity. Groups with Connections which do not support 
+	 * renumbering (Connection::allows_neuron_permutation) are left unchanged.
+	 *
+	 * Has to be called on all ranks after the network has been set up but 
+	 * before the first run. Monitors, pattern files and weight matrix files 
+	 * keep using the original ids: Monitors translate the ids they are given 
+	 * and are notified of the new ids if they were created before this call
+	 * (Monitor::permute_neurons). The functions of Connection which access 
+	 * the matrix in memory (get, set, get_ptr, get_block, ...) use the new 
+	 * ids (see SpikingGroup::get_original_id). */
+	void reorder_neurons();
+
+	/*! Computes the load of each SpikingGroup from the profile of the last run 
+	 * and writes it to a file which can be read with load_load_profile. 
+	 * The load of a group comprises its evolve and traces and the propagate and
+	 * plasticity of all Connections targeting it. Also logs the load imbalance 
+	 * between ranks. Requires profiling to be enabled (set_profiling) during 
+	 * the preceding run, which typically is a short warm-up run. */
+	void save_load_profile(string filename);
+
+	/*! Reads a load profile written by save_load_profile. SpikingGroups which 
+	 * are created after this call are distributed over the ranks according
+	 * to their measured load instead of their load multiplier 
+	 * (see SpikingGroup::set_load_profile). Connections follow the 
+	 * distribution of their target groups. Hence the profile needs to be 
+	 * loaded before the network is set up. */
+	void load_load_profile(string filename);
+
 	/*! Registers an instance of Checker to the checkers vector. 
 	 * 
 	 * Note: The first checker that is registered is by default used by System for the rate output in the progress bar.*/
@@ -27,6 +27,7 @@
 
 void TripletConnection::init(AurynFloat tau_hom, AurynFloat eta, AurynFloat kappa, AurynFloat maxweight)
 {
+	dw_pre_vector = NULL;
 	if ( dst->get_post_size() == 0 ) return; // avoids to run this code on silent nodes with zero post neurons.
 
 	/* Initialization of plasticity parameters. */
@@ -46,9 +47,12 @@ void TripletConnection::init(AurynFloat tau_hom, AurynFloat eta, AurynFloat kapp
 	tr_post = dst->get_post_trace(tau_minus);
 	tr_post2 = dst->get_post_trace(tau_long);
 	tr_post_hom = dst->get_post_trace(tau_hom);
+	lazy_pre_trace = tr_pre;
 
 	hom_fudge = A3_plus*tau_plus*tau_long/(tau_minus)/kappa/tau_hom/tau_hom;
 
+	dw_pre_vector = auryn_vector_float_alloc(dst->get_post_size());
+
 	/* Set min/max weight values. */
 	set_min_weight(0.0);
 	set_max_weight(maxweight);
@@ -75,10 +79,13 @@ void TripletConnection::finalize() {
 
 void TripletConnection::free()
 {
+	if ( dw_pre_vector != NULL ) 
+		auryn_vector_float_free(dw_pre_vector);
 }
 
 TripletConnection::TripletConnection(SpikingGroup * source, NeuronGroup * destination, TransmitterType transmitter) : DuplexConnection(source, destination, transmitter)
 {
+	dw_pre_vector = NULL;
 }
 
 TripletConnection::TripletConnection(SpikingGroup * source, NeuronGroup * destination, 
@@ -135,16 +142,6 @@ AurynWeight TripletConnection::get_hom(NeuronID i)
 }
 
 
-/*! This function implements what happens to synapes transmitting a 
- *  spike to neuron 'post'. */
-AurynWeight TripletConnection::dw_pre(NeuronID post)
-{
-	// translate post id to local id on rank: translated_spike
-	NeuronID translated_spike = dst->global2rank(post); 
-	AurynDouble dw = -hom_fudge*(tr_post->get(translated_spike)*get_hom(translated_spike));
-	return dw;
-}
-
 /*! This function implements what happens to synapes experiencing a 
  *  backpropagating action potential from neuron 'pre'. */
 AurynWeight TripletConnection::dw_post(NeuronID pre, NeuronID post)
@@ -156,35 +153,72 @@ AurynWeight TripletConnection::dw_post(NeuronID pre, NeuronID post)
 }
 
 
+void TripletConnection::compute_dw_pre_vector()
+{
+	// dw_pre = -hom_fudge * tr_post * get_hom
+	for ( NeuronID i = 0 ; i < dst->get_post_size() ; ++i ) 
+		dw_pre_vector->data[i] = get_hom(i);
+	auryn_vector_float_mul(dw_pre_vector, tr_post->get_state_ptr());
+	auryn_vector_float_scale(-hom_fudge, dw_pre_vector);
+}
+
 void TripletConnection::propagate_forward()
 {
+	const SpikeContainer * spikes = src->get_spikes();
+	// nothing to do without spikes or postsynaptic neurons on this rank
+	if ( spikes->empty() || dst->get_post_size() == 0 ) return;
+
+	const bool plastic = stdp_active;
+	const AurynFloat * dw = NULL;
+	if ( plastic ) {
+		compute_dw_pre_vector();
+		dw = dw_pre_vector->data;
+	}
+	const AurynWeight wmin = get_min_weight();
+
 	// loop over all spikes
-	for (SpikeContainer::const_iterator spike = src->get_spikes()->begin() ; // spike = pre_spike
-			spike != src->get_spikes()->end() ; ++spike ) {
+	for ( NeuronID k = 0 ; k < spikes->size() ; ++k ) {
+		const NeuronID spike = (*spikes)[k]; // spike = pre_spike
+		// prefetch the row of an upcoming spike
+		prefetch_spike_row(spikes, k);
 		// loop over all postsynaptic partners
-		for (const NeuronID * c = w->get_row_begin(*spike) ; 
-				c != w->get_row_end(*spike) ; 
+		for (const NeuronID * c = w->get_row_begin(spike) ; 
+				c != w->get_row_end(spike) ; 
 				++c ) { // c = post index
 
 			// transmit signal to target at postsynaptic neuron
 			AurynWeight * weight = w->get_data_ptr(c); 
+			if ( lazy_updates ) 
+				apply_pending_post_spikes(spike, dst->global2rank(*c), weight);
 			transmit( *c , *weight );
 
 			// handle plasticity
-			if ( stdp_active ) {
+			if ( plastic ) {
 				// performs weight update
-			    *weight += dw_pre(*c);
+			    *weight += dw[dst->global2rank(*c)];
 
 			    // clips too small weights
-			    if ( *weight < get_min_weight() ) 
-					*weight = get_min_weight();
+			    if ( *weight < wmin ) 
+					*weight = wmin;
 			}
 		}
+		if ( lazy_updates ) update_pending_row(spike);
 	}
 }
 
 void TripletConnection::propagate_backward()
 {
+	if (stdp_active && lazy_updates) { 
+		// only records the spikes together with the postsynaptic factor of dw_post
+		for (SpikeContainer::const_iterator spike = dst->get_spikes_immediate()->begin() ; // spike = post_spike
+				spike != dst->get_spikes_immediate()->end() ; 
+				++spike ) {
+			NeuronID translated_spike = dst->global2rank(*spike); 
+			add_pending_post_spike(translated_spike, A3_plus*tr_post2->get(translated_spike));
+		}
+		return;
+	}
+
 	if (stdp_active) { 
 		SpikeContainer::const_iterator spikes_end = dst->get_spikes_immediate()->end();
 		// loop over all spikes
@@ -195,21 +229,8 @@ void TripletConnection::propagate_backward()
 			// multiple times, we translate it here:
 			NeuronID translated_spike = dst->global2rank(*spike); 
 
-			// loop over all presynaptic partners
-			for (const NeuronID * c = bkw->get_row_begin(*spike) ; c != bkw->get_row_end(*spike) ; ++c ) {
-
-				#ifdef CODE_ACTIVATE_PREFETCHING_INTRINSICS
-				// prefetches next memory cells to reduce number of last-level cache misses
-				_mm_prefetch((const char *)bkw_data[c-bkw_ind+2],  _MM_HINT_NTA);
-				#endif
-
-				// computes plasticity update
-				AurynWeight * weight = bkw->get_data(c); 
-				*weight += dw_post(*c,translated_spike);
-
-				// clips too large weights
-				if (*weight>get_max_weight()) *weight=get_max_weight();
-			}
+			// dw_post of all presynaptic partners, clipped at the maximum weight
+			add_to_bkw_row(*spike, tr_pre, A3_plus, tr_post2->get(translated_spike));
 		}
 	}
 }
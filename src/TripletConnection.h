@@ -79,7 +79,7 @@ protected:
 	AurynWeight * fwd_data;
 
 	NeuronID * bkw_ind; 
-	AurynWeight ** bkw_data;
+	AurynInt * bkw_data;
 
 	AurynDouble hom_fudge;
 
@@ -91,19 +91,26 @@ protected:
 	DEFAULT_TRACE_MODEL * tr_post2;
 	DEFAULT_TRACE_MODEL * tr_post_hom;
 
+	/*! Weight change dw_pre of all postsynaptic neurons on this rank, 
+	 * indexed by their rank local id. Filled by compute_dw_pre_vector. */
+	auryn_vector_float * dw_pre_vector;
+
+	/*! Action on weight upon presynaptic spike. Evaluates the weight change 
+	 * dw_pre = -hom_fudge*tr_post*get_hom for all 
+	 * postsynaptic neurons on this rank at once and stores the result in 
+	 * dw_pre_vector (indexed by the rank local id). Called by propagate_forward
+	 * in time steps with presynaptic spikes. This function should be modified 
+	 * to define new spike based plasticity rules. */
+	virtual void compute_dw_pre_vector();
+
 	void propagate_forward();
 	void propagate_backward();
 	void sort_spikes();
 
-	/*! Action on weight upon presynaptic spike on connection with postsynaptic
-	 * partner post. This function should be modified to define new spike based
-	 * plasticity rules. 
-	 * @param post the postsynaptic cell from which the synaptic trace is read out*/
-	AurynWeight dw_pre(NeuronID post);
-
 	/*! Action on weight upon postsynaptic spike of cell post on connection
 	 * with presynaptic partner pre. This function should be modified to define
-	 * new spike based plasticity rules. 
+	 * new spike based plasticity rules. propagate_backward applies it to all 
+	 * presynaptic partners at once with DuplexConnection::add_to_bkw_row.
 	 * @param pre the presynaptic cell in question.
 	 * @param post the postsynaptic cell in question. 
 	 */ 
@@ -92,6 +92,7 @@ void TripletDecayConnection::propagate()
 	// decay of weights
 	if ( stdp_active ) {
 		if ( decay_count == 0 ) {
+			apply_pending_updates();
 			for ( AurynWeight * i = w->get_data_begin() ; i != w->get_data_end() ; ++i ) {
 				// *i *= mul_decay;
 				*i = w_rest + mul_decay*(*i-w_rest);
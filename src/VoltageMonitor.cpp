@@ -43,8 +43,9 @@ void VoltageMonitor::init(NeuronGroup * source, NeuronID id, string filename, Au
 
 	if ( ssize < 1 ) ssize = 1;
 
-	nid = id;
-	gid = src->rank2global(nid);
+	gid = src->rank2global(id);
+	if ( gid < src->get_size() ) gid = src->get_renumbered_id(gid); // see System::reorder_neurons
+	nid = src->global2rank(gid);
 	paste_spikes = true;
 
 	tStop = -1; // at the end of all times ...
@@ -52,7 +53,7 @@ void VoltageMonitor::init(NeuronGroup * source, NeuronID id, string filename, Au
 	if ( nid < src->get_post_size() ) {
 		sys->register_monitor(this);
 		outfile << setiosflags(ios::fixed) << setprecision(6);
-		outfile << "# Recording from neuron " << gid << "\n";
+		outfile << "# Recording from neuron " << src->get_original_id(gid) << "\n";
 	}
 }
 
@@ -67,3 +68,15 @@ void VoltageMonitor::propagate()
 			outfile << (sys->get_time()) << " " << src->get_mem(nid) << "\n";
 	}
 }
+
+void VoltageMonitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+	if ( group != src || gid >= src->get_size() ) return;
+	gid = new_ids[gid];
+	nid = src->global2rank(gid);
+}
+
+SpikingGroup * VoltageMonitor::get_source()
+{
+	return src;
+}
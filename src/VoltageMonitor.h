@@ -74,6 +74,10 @@ public:
 	VoltageMonitor(NeuronGroup * source, NeuronID id, string filename,  AurynDouble stepsize=dt);
 	virtual ~VoltageMonitor();
 	void propagate();
+	/*! Follows the recorded neuron when its group is renumbered */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
+	/*! Returns the source group (see Monitor::get_source) */
+	virtual SpikingGroup * get_source();
 };
 
 #endif /*VOLTAGEMONITOR_H_*/
@@ -51,6 +51,9 @@ WeightMonitor::WeightMonitor(SparseConnection * source, NeuronID i, NeuronID j,
 				add_to_list(mat->get_data_begin()+c) ;
 			break;
 		case SINGLE :
+			// like the other monitors takes original ids (see System::reorder_neurons)
+			if ( i < src->get_source()->get_size() ) i = src->get_source()->get_renumbered_id(i);
+			if ( j < src->get_destination()->get_size() ) j = src->get_destination()->get_renumbered_id(j);
 			add_to_list(i,j);
 			break;
 	}
@@ -88,8 +91,18 @@ void WeightMonitor::init(SparseConnection * source, NeuronID i, NeuronID j, stri
 
 void WeightMonitor::add_to_list(AurynWeight * ptr)
 {
-	if ( ptr != NULL )
-		element_list->push_back( ptr );
+	if ( ptr == NULL ) return;
+	element_list->push_back( ptr );
+
+	neuron_pair a;
+	a.i = mat->get_m_rows();
+	a.j = 0;
+	const AurynLong k = ptr-mat->get_data_begin();
+	if ( ptr >= mat->get_data_begin() && k < mat->get_nonzero() ) {
+		a.i = mat->get_rowind(k);
+		a.j = mat->get_colind(k);
+	}
+	element_ids.push_back( a );
 }
 
 void WeightMonitor::add_to_list(NeuronID i, NeuronID j)
@@ -150,7 +163,7 @@ void WeightMonitor::load_data_range( NeuronID i, NeuronID j )
 		<< j;
 	logger->msg(oss.str(),DEBUG);
 	for ( NeuronID a = i ; a < j ; ++a )
-		element_list->push_back( mat->get_data_begin()+a );
+		add_to_list( mat->get_data_begin()+a );
 	outfile << "# Added data range " << i << "-" << j << "." << endl;
 }
 
@@ -248,6 +261,9 @@ void WeightMonitor::load_pattern_connections( string filename_pre, string filena
 						neuron_pair p;
 						p.i = patterns_pre->at(i)[k].i;
 						p.j = patterns_post->at(j)[l].i;
+						// the pattern files contain original ids (see System::reorder_neurons)
+						if ( p.i < src->get_source()->get_size() ) p.i = src->get_source()->get_renumbered_id(p.i);
+						if ( p.j < src->get_destination()->get_size() ) p.j = src->get_destination()->get_renumbered_id(p.j);
 						AurynWeight * ptr = mat->get_ptr(p.i,p.j);
 						if ( ptr != NULL ) // make sure we are counting connections that do exist
 							list.push_back( p );
@@ -310,6 +326,7 @@ void WeightMonitor::propagate()
 {
 	if ( src->get_destination()->evolve_locally() ) {
 		if (sys->get_clock()%ssize==0) {
+			src->apply_pending_updates();
 			outfile << fixed << dt*(sys->get_clock()) << scientific << " ";
 			if ( recordingmode == GROUPS ) record_synapse_groups();
 			else record_single_synapses();
@@ -322,3 +339,19 @@ void WeightMonitor::set_mat(ForwardMatrix * m)
 {
 	mat = m;
 }
+
+void WeightMonitor::permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids)
+{
+	const bool pre = ( src->get_source() == group );
+	const bool post = ( src->get_destination() == group );
+	if ( !pre && !post ) return;
+
+	// the matrix has been permuted in place
+	for ( AurynLong k = 0 ; k < element_ids.size() ; ++k ) {
+		neuron_pair & a = element_ids[k];
+		if ( a.i >= mat->get_m_rows() ) continue;
+		if ( pre ) a.i = new_ids[a.i];
+		if ( post ) a.j = new_ids[a.j];
+		element_list->at(k) = mat->get_ptr(a.i,a.j);
+	}
+}
@@ -76,6 +76,10 @@ protected:
 	NeuronID elem_j;
 	AurynTime ssize;
 	vector<AurynWeight*> * element_list;
+	/*! Row and column of each element of element_list in current ids. Used to 
+	 * follow the elements when the neurons are renumbered. Elements outside 
+	 * of mat have a row of mat->get_m_rows(). */
+	vector<neuron_pair> element_ids;
 	vector<NeuronID> group_indices;
 	void init(SparseConnection * source, NeuronID i, NeuronID j, string filename, AurynTime interval);
 
@@ -93,10 +97,16 @@ public:
 
 	void set_mat(ForwardMatrix * m);
 
+	/*! Follows the recorded synapses when the neurons of the source or 
+	 * destination of the connection are renumbered */
+	virtual void permute_neurons(SpikingGroup * group, const vector<NeuronID> & new_ids);
+
 
 	/*! Adds a single element identified by a pointer to the recording list. */
 	void add_to_list( AurynWeight * ptr );
-	/*! Adds a single element identified matrix coordinates (row,col) to the recording list. */
+	/*! Adds a single element identified matrix coordinates (row,col) to the 
+	 * recording list. Like get_ptr and SparseConnection::get_block the 
+	 * coordinates are the current ids (see System::reorder_neurons). */
 	void add_to_list( NeuronID i, NeuronID j );
 	/*! Adds a list vector<neuron_pair> vec the the recording list. Such a list
 	 * can for instance be generated by a SparseConnection with the get_block 
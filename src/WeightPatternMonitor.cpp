@@ -59,6 +59,9 @@ AurynWeight WeightPatternMonitor::compute_pattern_mean(const NeuronID i, const N
 		for ( NeuronID l = 0 ; l < post_patterns[j].size() ; ++l ) {
 			pattern_member p = pre_patterns[i][k];
 			pattern_member q = post_patterns[j][l];
+			// the patterns contain original ids (see System::reorder_neurons)
+			if ( p.i < src->get_source()->get_size() ) p.i = src->get_source()->get_renumbered_id(p.i);
+			if ( q.i < src->get_destination()->get_size() ) q.i = src->get_destination()->get_renumbered_id(q.i);
 			AurynWeight * val = src->get_ptr(p.i,q.i);
 			if ( val ) {
 				sum += *val;
@@ -74,6 +77,7 @@ AurynWeight WeightPatternMonitor::compute_pattern_mean(const NeuronID i, const N
 void WeightPatternMonitor::propagate()
 {
 	if (sys->get_clock()%ssize==0) {
+		src->apply_pending_updates();
 		outfile << fixed << (sys->get_time()) << " ";
 
 		int p = min(min(pre_patterns.size(),post_patterns.size()),max_patterns);
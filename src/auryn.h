@@ -46,6 +46,7 @@
 
 // Trace definitions
 #include "LinearTrace.h"
+#include "CounterRandomStream.h"
 #include "EulerTrace.h"
 
 // Connection definitions
@@ -61,6 +62,8 @@
 #include "DuplexConnection.h"
 #include "TripletDecayConnection.h"
 #include "IdentityConnection.h"
+#include "ProceduralConnection.h"
+#include "QuantizedConnection.h"
 
 // Spiking and Neuron group definitions
 #include "IF2Group.h"
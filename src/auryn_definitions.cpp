@@ -67,20 +67,404 @@ inline void sse_store( float * i, __m128 d )
 #endif
 }
 
-void auryn_vector_float_mul( auryn_vector_float * a, auryn_vector_float * b)
+static void scalar_indexed_saxpy_clip( const float a, const float b, const float * x, const NeuronID * idx, 
+		float * w, const AurynInt * offsets, const float wmax, const NeuronID n )
 {
-#ifdef CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY
-	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
-	a->data[0:a->size:1] = a->data[0:a->size:1] * b->data[0:b->size:1];
-	#else
-	float * bd = b->data;
-	for ( float * i = a->data ; i != a->data+a->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	for ( NeuronID k = 0 ; k < n ; ++k ) {
+		float * weight = w+offsets[k];
+		*weight += (a*x[idx[k]])*b;
+		if ( *weight > wmax ) *weight = wmax;
+	}
+}
+
+#if defined(CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY) && !defined(CODE_ACTIVATE_CILK_INSTRUCTIONS)
+/* The kernels below run over whole registers and may therefore touch the 
+ * padding behind the last element which auryn_vector_float_alloc provides. */
+
+static void sse_mul( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
 	{
 		__m128 chunk_a = sse_load( i );
-		__m128 chunk_b = sse_load( bd ); bd+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		__m128 chunk_b = sse_load( (float*)b ); b+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
 		__m128 result = _mm_mul_ps(chunk_a, chunk_b);
 		sse_store( i, result );
 	}
+}
+
+static void sse_add( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk_a = sse_load( i );
+		__m128 chunk_b = sse_load( (float*)b ); b+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		__m128 result = _mm_add_ps(chunk_a, chunk_b);
+		sse_store( i, result );
+	}
+}
+
+static void sse_sub( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk_a = sse_load( i );
+		__m128 chunk_b = sse_load( (float*)b ); b+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		__m128 result = _mm_sub_ps(chunk_a, chunk_b);
+		sse_store( i, result );
+	}
+}
+
+static void sse_add_constant( float * a, const float b, const NeuronID n )
+{
+	const __m128 scalar = _mm_set1_ps(b);
+	for ( float * i = a ; i < a+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk = sse_load( i );
+		__m128 result = _mm_add_ps(chunk, scalar);
+		sse_store( i, result );
+	}
+}
+
+static void sse_scale( const float a, float * b, const NeuronID n )
+{
+	const __m128 scalar = _mm_set1_ps(a);
+	for ( float * i = b ; i < b+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk = sse_load( i );
+		__m128 result = _mm_mul_ps(chunk, scalar);
+		sse_store( i, result );
+	}
+}
+
+static void sse_saxpy( const float a, const float * x, float * y, const NeuronID n )
+{
+	const __m128 alpha = _mm_set1_ps(a);
+	for ( float * i = y ; i < y+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk = sse_load( (float*)x ); x += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		__m128 result     = _mm_mul_ps( alpha, chunk );
+
+		chunk  = sse_load( i );
+		result = _mm_add_ps( result, chunk );
+		sse_store( i, result ); 
+	}
+}
+
+static void sse_clip( float * v, const float a, const float b, const NeuronID n )
+{
+	const __m128 lo = _mm_set1_ps(a);
+	const __m128 hi = _mm_set1_ps(b);
+	for ( float * i = v ; i < v+n ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m128 chunk = sse_load( i );
+		__m128 result = _mm_min_ps(chunk, hi);
+		result = _mm_max_ps(result, lo);
+		sse_store( i, result );
+	}
+}
+
+
+#ifdef CODE_USE_RUNTIME_SIMD_DISPATCH
+#define AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS 8
+#define AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS 16
+
+__attribute__((target("avx2"))) inline __m256 avx_load( const float * i ) 
+{
+#ifdef CODE_ALIGNED_SIMD_INSTRUCTIONS
+	return _mm256_load_ps( i );
+#else
+	return _mm256_loadu_ps( i );
+#endif
+}
+
+__attribute__((target("avx2"))) inline void avx_store( float * i, __m256 d ) 
+{
+#ifdef CODE_ALIGNED_SIMD_INSTRUCTIONS
+	_mm256_store_ps( i, d );
+#else
+	_mm256_storeu_ps( i, d );
+#endif
+}
+
+__attribute__((target("avx2"))) static void avx2_mul( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m256 chunk_a = avx_load( i );
+		__m256 chunk_b = avx_load( b ); b+=AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx_store( i, _mm256_mul_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx2"))) static void avx2_add( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m256 chunk_a = avx_load( i );
+		__m256 chunk_b = avx_load( b ); b+=AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx_store( i, _mm256_add_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx2"))) static void avx2_sub( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m256 chunk_a = avx_load( i );
+		__m256 chunk_b = avx_load( b ); b+=AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx_store( i, _mm256_sub_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx2"))) static void avx2_add_constant( float * a, const float b, const NeuronID n )
+{
+	const __m256 scalar = _mm256_set1_ps(b);
+	for ( float * i = a ; i < a+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx_store( i, _mm256_add_ps(avx_load( i ), scalar) );
+}
+
+__attribute__((target("avx2"))) static void avx2_scale( const float a, float * b, const NeuronID n )
+{
+	const __m256 scalar = _mm256_set1_ps(a);
+	for ( float * i = b ; i < b+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx_store( i, _mm256_mul_ps(avx_load( i ), scalar) );
+}
+
+__attribute__((target("avx2"))) static void avx2_saxpy( const float a, const float * x, float * y, const NeuronID n )
+{
+	const __m256 alpha = _mm256_set1_ps(a);
+	for ( float * i = y ; i < y+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m256 result = _mm256_mul_ps( alpha, avx_load( x ) ); x += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		result = _mm256_add_ps( result, avx_load( i ) ); // no FMA to stay bitwise identical to the SSE kernels
+		avx_store( i, result ); 
+	}
+}
+
+__attribute__((target("avx2"))) static void avx2_clip( float * v, const float a, const float b, const NeuronID n )
+{
+	const __m256 lo = _mm256_set1_ps(a);
+	const __m256 hi = _mm256_set1_ps(b);
+	for ( float * i = v ; i < v+n ; i += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx_store( i, _mm256_max_ps(_mm256_min_ps(avx_load( i ), hi), lo) );
+}
+
+// AVX2 has gathers but no scatters, the results are written back one by one
+__attribute__((target("avx2"))) static void avx2_indexed_saxpy_clip( const float a, const float b, const float * x, const NeuronID * idx, 
+		float * w, const AurynInt * offsets, const float wmax, const NeuronID n )
+{
+	const __m256 alpha = _mm256_set1_ps(a);
+	const __m256 beta = _mm256_set1_ps(b);
+	const __m256 hi = _mm256_set1_ps(wmax);
+	float result[AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS];
+	NeuronID k = 0;
+	for ( ; k+AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS <= n ; k += AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		const __m256i vidx = _mm256_loadu_si256( (const __m256i *)(idx+k) );
+		const __m256i voff = _mm256_loadu_si256( (const __m256i *)(offsets+k) );
+		const __m256 trace = _mm256_i32gather_ps( x, vidx, 4 );
+		const __m256 weight = _mm256_i32gather_ps( w, voff, 4 );
+		const __m256 dw = _mm256_mul_ps( _mm256_mul_ps( alpha, trace ), beta );
+		_mm256_storeu_ps( result, _mm256_min_ps( _mm256_add_ps( weight, dw ), hi ) );
+		for ( int l = 0 ; l < AVX2_NUM_OF_PARALLEL_FLOAT_OPERATIONS ; ++l ) 
+			w[offsets[k+l]] = result[l];
+	}
+	scalar_indexed_saxpy_clip( a, b, x, idx+k, w, offsets+k, wmax, n-k );
+}
+
+__attribute__((target("avx512f"))) inline __m512 avx512_load( const float * i ) 
+{
+#ifdef CODE_ALIGNED_SIMD_INSTRUCTIONS
+	return _mm512_load_ps( i );
+#else
+	return _mm512_loadu_ps( i );
+#endif
+}
+
+__attribute__((target("avx512f"))) inline void avx512_store( float * i, __m512 d ) 
+{
+#ifdef CODE_ALIGNED_SIMD_INSTRUCTIONS
+	_mm512_store_ps( i, d );
+#else
+	_mm512_storeu_ps( i, d );
+#endif
+}
+
+__attribute__((target("avx512f"))) static void avx512_mul( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m512 chunk_a = avx512_load( i );
+		__m512 chunk_b = avx512_load( b ); b+=AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx512_store( i, _mm512_mul_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx512f"))) static void avx512_add( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m512 chunk_a = avx512_load( i );
+		__m512 chunk_b = avx512_load( b ); b+=AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx512_store( i, _mm512_add_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx512f"))) static void avx512_sub( float * a, const float * b, const NeuronID n )
+{
+	for ( float * i = a ; i < a+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m512 chunk_a = avx512_load( i );
+		__m512 chunk_b = avx512_load( b ); b+=AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		avx512_store( i, _mm512_sub_ps(chunk_a, chunk_b) );
+	}
+}
+
+__attribute__((target("avx512f"))) static void avx512_add_constant( float * a, const float b, const NeuronID n )
+{
+	const __m512 scalar = _mm512_set1_ps(b);
+	for ( float * i = a ; i < a+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx512_store( i, _mm512_add_ps(avx512_load( i ), scalar) );
+}
+
+__attribute__((target("avx512f"))) static void avx512_scale( const float a, float * b, const NeuronID n )
+{
+	const __m512 scalar = _mm512_set1_ps(a);
+	for ( float * i = b ; i < b+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx512_store( i, _mm512_mul_ps(avx512_load( i ), scalar) );
+}
+
+__attribute__((target("avx512f"))) static void avx512_saxpy( const float a, const float * x, float * y, const NeuronID n )
+{
+	const __m512 alpha = _mm512_set1_ps(a);
+	for ( float * i = y ; i < y+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		__m512 result = _mm512_mul_ps( alpha, avx512_load( x ) ); x += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+		result = _mm512_add_ps( result, avx512_load( i ) ); 
+		avx512_store( i, result ); 
+	}
+}
+
+__attribute__((target("avx512f"))) static void avx512_clip( float * v, const float a, const float b, const NeuronID n )
+{
+	const __m512 lo = _mm512_set1_ps(a);
+	const __m512 hi = _mm512_set1_ps(b);
+	for ( float * i = v ; i < v+n ; i += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+		avx512_store( i, _mm512_max_ps(_mm512_min_ps(avx512_load( i ), hi), lo) );
+}
+
+__attribute__((target("avx512f"))) static void avx512_indexed_saxpy_clip( const float a, const float b, const float * x, const NeuronID * idx, 
+		float * w, const AurynInt * offsets, const float wmax, const NeuronID n )
+{
+	const __m512 alpha = _mm512_set1_ps(a);
+	const __m512 beta = _mm512_set1_ps(b);
+	const __m512 hi = _mm512_set1_ps(wmax);
+	NeuronID k = 0;
+	for ( ; k+AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS <= n ; k += AVX512_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
+	{
+		const __m512i vidx = _mm512_loadu_si512( (const void *)(idx+k) );
+		const __m512i voff = _mm512_loadu_si512( (const void *)(offsets+k) );
+		const __m512 trace = _mm512_i32gather_ps( vidx, x, 4 );
+		const __m512 weight = _mm512_i32gather_ps( voff, w, 4 );
+		const __m512 dw = _mm512_mul_ps( _mm512_mul_ps( alpha, trace ), beta );
+		// the offsets within a row of the backward matrix are distinct
+		_mm512_i32scatter_ps( w, voff, _mm512_min_ps( _mm512_add_ps( weight, dw ), hi ), 4 );
+	}
+	scalar_indexed_saxpy_clip( a, b, x, idx+k, w, offsets+k, wmax, n-k );
+}
+#endif /* CODE_USE_RUNTIME_SIMD_DISPATCH */
+
+
+/*! Table of the vector kernels selected at startup */
+struct auryn_vector_float_kernels {
+	void (*mul)( float * a, const float * b, const NeuronID n );
+	void (*add)( float * a, const float * b, const NeuronID n );
+	void (*sub)( float * a, const float * b, const NeuronID n );
+	void (*add_constant)( float * a, const float b, const NeuronID n );
+	void (*scale)( const float a, float * b, const NeuronID n );
+	void (*saxpy)( const float a, const float * x, float * y, const NeuronID n );
+	void (*clip)( float * v, const float a, const float b, const NeuronID n );
+	void (*indexed_saxpy_clip)( const float a, const float b, const float * x, const NeuronID * idx, 
+			float * w, const AurynInt * offsets, const float wmax, const NeuronID n );
+};
+
+static auryn_vector_float_kernels simd_kernels = { 
+	sse_mul, sse_add, sse_sub, sse_add_constant, sse_scale, sse_saxpy, sse_clip, scalar_indexed_saxpy_clip };
+#endif /* CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY */
+
+static SimdLevelType simd_level = SIMD_SSE;
+
+static SimdLevelType auryn_get_supported_simd_level()
+{
+#ifdef CODE_USE_RUNTIME_SIMD_DISPATCH
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports("avx512f") ) return SIMD_AVX512;
+	if ( __builtin_cpu_supports("avx2") ) return SIMD_AVX2;
+#endif /* CODE_USE_RUNTIME_SIMD_DISPATCH */
+	return SIMD_SSE;
+}
+
+SimdLevelType auryn_set_simd_level(SimdLevelType level)
+{
+	const SimdLevelType supported = auryn_get_supported_simd_level();
+	if ( level > supported ) level = supported;
+
+#ifdef CODE_USE_RUNTIME_SIMD_DISPATCH
+	switch ( level ) {
+		case SIMD_AVX512: 
+			{
+				const auryn_vector_float_kernels k = { 
+					avx512_mul, avx512_add, avx512_sub, avx512_add_constant, avx512_scale, avx512_saxpy, avx512_clip,
+					avx512_indexed_saxpy_clip };
+				simd_kernels = k;
+			}
+			break;
+		case SIMD_AVX2: 
+			{
+				const auryn_vector_float_kernels k = { 
+					avx2_mul, avx2_add, avx2_sub, avx2_add_constant, avx2_scale, avx2_saxpy, avx2_clip,
+					avx2_indexed_saxpy_clip };
+				simd_kernels = k;
+			}
+			break;
+		default: 
+			{
+				const auryn_vector_float_kernels k = { 
+					sse_mul, sse_add, sse_sub, sse_add_constant, sse_scale, sse_saxpy, sse_clip,
+					scalar_indexed_saxpy_clip };
+				simd_kernels = k;
+			}
+	}
+#endif /* CODE_USE_RUNTIME_SIMD_DISPATCH */
+
+	simd_level = level;
+	return simd_level;
+}
+
+SimdLevelType auryn_get_simd_level()
+{
+	return simd_level;
+}
+
+string auryn_get_simd_level_name()
+{
+	switch ( simd_level ) {
+		case SIMD_AVX512: return "AVX-512";
+		case SIMD_AVX2: return "AVX2";
+		default: return "SSE";
+	}
+}
+
+// selects the widest supported kernels before main is entered
+static const SimdLevelType simd_level_at_startup = auryn_set_simd_level(SIMD_AVX512);
+
+void auryn_vector_float_mul( auryn_vector_float * a, auryn_vector_float * b)
+{
+#ifdef CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY
+	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
+	a->data[0:a->size:1] = a->data[0:a->size:1] * b->data[0:b->size:1];
+	#else
+	simd_kernels.mul( a->data, b->data, a->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < a->size ; ++i ) {
@@ -95,14 +479,7 @@ void auryn_vector_float_add_constant( auryn_vector_float * a, const float b )
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	a->data[0:a->size:1] = b + a->data[0:a->size:1];
 	#else
-	const __m128 scalar = _mm_set1_ps(b);
-	for ( float * i = a->data ; i != a->data+a->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		// _mm_prefetch((i + SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS),  _MM_HINT_NTA);  
-		__m128 chunk = sse_load( i );
-		__m128 result = _mm_add_ps(chunk, scalar);
-		sse_store( i, result );
-	}
+	simd_kernels.add_constant( a->data, b, a->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < a->size ; ++i ) {
@@ -117,13 +494,7 @@ void auryn_vector_float_scale( const float a, const auryn_vector_float * b )
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	b->data[0:b->size:1] = a * b->data[0:b->size:1];
 	#else
-	const __m128 scalar = _mm_set1_ps(a);
-	for ( float * i = b->data ; i != b->data+b->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk = sse_load( i );
-		__m128 result = _mm_mul_ps(chunk, scalar);
-		sse_store( i, result );
-	}
+	simd_kernels.scale( a, b->data, b->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < b->size ; ++i ) {
@@ -138,17 +509,7 @@ void auryn_vector_float_saxpy( const float a, const auryn_vector_float * x, cons
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	y->data[0:y->size:1] = a * x->data[0:x->size:1] + y->data[0:y->size:1];
 	#else
-	float * xp = x->data;
-	const __m128 alpha = _mm_set1_ps(a);
-	for ( float * i = y->data ; i < y->data+y->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk = sse_load( xp ); xp += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
-		__m128 result     = _mm_mul_ps( alpha, chunk );
-
-		chunk  = sse_load( i );
-		result = _mm_add_ps( result, chunk );
-		sse_store( i, result ); 
-	}
+	simd_kernels.saxpy( a, x->data, y->data, y->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < y->size ; ++i ) {
@@ -163,14 +524,7 @@ void auryn_vector_float_add( auryn_vector_float * a, auryn_vector_float * b)
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	a->data[0:a->size:1] = a->data[0:a->size:1] + b->data[0:b->size:1];
 	#else
-	float * bd = b->data;
-	for ( float * i = a->data ; i != a->data+a->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk_a = sse_load( i );
-		__m128 chunk_b = sse_load( bd ); bd+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
-		__m128 result = _mm_add_ps(chunk_a, chunk_b);
-		sse_store( i, result );
-	}
+	simd_kernels.add( a->data, b->data, a->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < a->size ; ++i ) {
@@ -185,14 +539,7 @@ void auryn_vector_float_sub( auryn_vector_float * a, auryn_vector_float * b)
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	a->data[0:a->size:1] = a->data[0:a->size:1] - b->data[0:b->size:1];
 	#else
-	float * bd = b->data;
-	for ( float * i = a->data ; i != a->data+a->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk_a = sse_load( i );
-		__m128 chunk_b = sse_load( bd ); bd+=SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
-		__m128 result = _mm_sub_ps(chunk_a, chunk_b);
-		sse_store( i, result );
-	}
+	simd_kernels.sub( a->data, b->data, a->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < a->size ; ++i ) {
@@ -212,15 +559,7 @@ void auryn_vector_float_clip( auryn_vector_float * v, const float a, const float
 				v->data[i] = b;
 	}
 	#else
-	const __m128 lo = _mm_set1_ps(a);
-	const __m128 hi = _mm_set1_ps(b);
-	for ( float * i = v->data ; i != v->data+v->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk = sse_load( i );
-		__m128 result = _mm_min_ps(chunk, hi);
-		result = _mm_max_ps(result, lo);
-		sse_store( i, result );
-	}
+	simd_kernels.clip( v->data, a, b, v->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	for ( NeuronID i = 0 ; i < v->size ; ++i ) {
@@ -238,23 +577,33 @@ void auryn_vector_float_clip( auryn_vector_float * v, const float a ) {
 	#ifdef CODE_ACTIVATE_CILK_INSTRUCTIONS
 	auryn_vector_float_clip( v, a, 1e16 );
 	#else
-	const __m128 lo = _mm_set1_ps(a);
-	const __m128 hi = _mm_set1_ps(0.);
-	for ( float * i = v->data ; i != v->data+v->size ; i += SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS )
-	{
-		__m128 chunk = sse_load( i );
-		__m128 result = _mm_min_ps(chunk, hi);
-		result = _mm_max_ps(result, lo);
-		sse_store( i, result );
-	}
+	simd_kernels.clip( v->data, a, 0., v->size );
 	#endif /* CODE_ACTIVATE_CILK_INSTRUCTIONS */
 #else
 	auryn_vector_float_clip( v, a, 1e16 );
 #endif
 }
 
+void auryn_indexed_saxpy_clip( const float a, const float b, const float * x, const NeuronID * idx, 
+		float * w, const AurynInt * offsets, const float wmax, const NeuronID n )
+{
+#if defined(CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY) && !defined(CODE_ACTIVATE_CILK_INSTRUCTIONS)
+	simd_kernels.indexed_saxpy_clip( a, b, x, idx, w, offsets, wmax, n );
+#else
+	scalar_indexed_saxpy_clip( a, b, x, idx, w, offsets, wmax, n );
+#endif
+}
+
 auryn_vector_float * auryn_vector_float_alloc( const NeuronID n ) {
-	AurynFloat * data = new AurynFloat [n];
+	// pad to whole AVX-512 registers so that every kernel can run over the tail
+	const NeuronID padded = ((n+SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS-1)/SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS)
+		*SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS;
+	void * mem = NULL;
+	if ( posix_memalign( &mem, SIMD_MEMORY_ALIGNMENT, (padded>0?padded:1)*sizeof(AurynFloat) ) ) 
+		throw AurynMemoryAlignmentException();
+	AurynFloat * data = static_cast<AurynFloat*>(mem);
+	for ( NeuronID i = 0 ; i < padded ; ++i ) 
+		data[i] = 0.0;
 	auryn_vector_float * vec = new auryn_vector_float();
 	vec->size = n;
 	vec->data = data;
@@ -262,7 +611,7 @@ auryn_vector_float * auryn_vector_float_alloc( const NeuronID n ) {
 }
 
 void auryn_vector_float_free ( auryn_vector_float * v ) {
-	delete [] v->data;
+	std::free(v->data);
 	delete v;
 }
 
@@ -88,8 +88,59 @@ namespace mpi = boost::mpi;
 
 #define SIMD_NUM_OF_PARALLEL_FLOAT_OPERATIONS 4 //!< SSE can process 4 floats in parallel
 
+/*! Select AVX2 or AVX-512 versions of the auryn_vector_float
+ * operations at startup when the CPU supports them. The wider
+ * kernels are compiled with function-specific target attributes
+ * so that the same binary runs on machines without AVX.
+ * Requires GCC 4.9 or newer on x86_64. */
+#define CODE_USE_RUNTIME_SIMD_DISPATCH
+#if !defined(__x86_64__) || !defined(__GNUC__) || defined(__clang__) || (__GNUC__ < 5 && !(__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#undef CODE_USE_RUNTIME_SIMD_DISPATCH
+#endif
+#if !defined(CODE_USE_SIMD_INSTRUCTIONS_EXPLICITLY) || defined(CODE_ACTIVATE_CILK_INSTRUCTIONS)
+#undef CODE_USE_RUNTIME_SIMD_DISPATCH
+#endif
+
+#define SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS 16 //!< AVX-512 can process 16 floats in parallel
+#define SIMD_MEMORY_ALIGNMENT 64 //!< Alignment of auryn_vector_float data in bytes (one AVX-512 register or cache line)
+
+/*! Toggle fused neuron updates in AIFGroup, AIF2Group and IF2Group 
+ * which integrate conductances, membrane and threshold in a single 
+ * pass over the state vectors instead of a chain of vector operations. */
+#define CODE_USE_FUSED_NEURON_KERNELS
+
+/*! Number of neurons integrated at once by the fused neuron updates 
+ * before their thresholds are checked. Chosen such that the state of
+ * one block stays in L1 cache. */
+#define FUSED_KERNEL_BLOCK_SIZE 256
+
+/*! Toggle 16 bit rank local column indices in SparseConnection::propagate.
+ * When the postsynaptic ranks have less than 65536 neurons, the forward 
+ * matrix keeps a copy of its column indices which are already translated 
+ * by global2rank. The copy is kept next to the 32 bit indices and costs 
+ * 2 bytes per synapse, e.g. 6 instead of 4 bytes for matrices with 
+ * uniform weights. Off by default. */
+// #define CODE_USE_LOCAL_COLUMN_INDICES
+
 // #define CODE_COLLECT_SYNC_TIMING_STATS //!< toggle  collection of timing data on sync/all_gather
 
+/*! Toggle non-blocking spike exchange between ranks. The exchange
+ * is started right after each sync step and only completed before
+ * the delayed spikes are propagated, so that it overlaps with the 
+ * integration of the SpikingGroups. Requires MPI 3. */
+#define CODE_USE_NONBLOCKING_SYNC
+#if defined(MPI_VERSION) && MPI_VERSION < 3
+#undef CODE_USE_NONBLOCKING_SYNC
+#endif
+
+/*! Toggle multithreaded evolve and propagate on each rank
+ * (see System::set_num_threads). Only takes effect when
+ * compiling with OpenMP support (-fopenmp). */
+#define CODE_ACTIVATE_OPENMP_THREADS
+#ifndef _OPENMP
+#undef CODE_ACTIVATE_OPENMP_THREADS
+#endif
+
 /*! System wide integration time step */
 const double dt = 1.0e-4;
 
@@ -132,6 +183,22 @@ enum TransmitterType {
 
 enum StimulusGroupModeType { MANUAL, RANDOM, SEQUENTIAL, SEQUENTIAL_REV, STIMFILE };
 
+/*! Specifies the number format in which a 
+ * QuantizedConnection stores its weights. */
+enum QuantizationType { 
+	QUANT_FP16, //!< IEEE 754 half precision floats
+	QUANT_BF16, //!< bfloat16, i.e. floats truncated to their upper 16 bits
+	QUANT_INT8  //!< 8 bit integers with one scale factor per row
+};
+
+/*! Specifies the instruction set used by the 
+ * auryn_vector_float operations. */
+enum SimdLevelType { 
+	SIMD_SSE,   //!< 128 bit kernels (always available)
+	SIMD_AVX2,  //!< 256 bit kernels
+	SIMD_AVX512 //!< 512 bit kernels
+};
+
 
 typedef unsigned int NeuronID; //!< NeuronID is an unsigned integeger type used to index neurons in Auryn.
 typedef NeuronID AurynInt;
@@ -185,13 +252,28 @@ typedef vector<pattern_member> type_pattern;
  @param align required alignment, in bytes */
 int auryn_AlignOffset (const int N, const void *vp, const int inc, const int align);  
 
-/*! Rounds vector size to multiple of four to allow using the SSE optimizations. */
+/*! Rounds vector size to multiple of four to allow using the SSE optimizations. 
+ * Note that auryn_vector_float_alloc additionally pads the underlying memory
+ * to SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS so that the wider kernels 
+ * can run over the last incomplete register. */
 NeuronID calculate_vector_size(NeuronID i);
 
+/*! Returns the instruction set currently used by the vector operations. */
+SimdLevelType auryn_get_simd_level();
+
+/*! Selects the instruction set used by the vector operations. Levels not 
+ * supported by the CPU are lowered to the best supported one. By default the 
+ * best supported level is selected at startup. Returns the level in use. */
+SimdLevelType auryn_set_simd_level(SimdLevelType level);
+
+/*! Returns a human readable name of the instruction set in use. */
+string auryn_get_simd_level_name();
+
 
 // Float vector functions
 
-/*! Allocates an auryn_vector_float */
+/*! Allocates an auryn_vector_float. The data is aligned to SIMD_MEMORY_ALIGNMENT 
+ * and zero padded to a multiple of SIMD_MAX_NUM_OF_PARALLEL_FLOAT_OPERATIONS. */
 auryn_vector_float * auryn_vector_float_alloc(const NeuronID n);
 /*! Frees an auryn_vector_float */
 void auryn_vector_float_free (auryn_vector_float * v);
@@ -226,6 +308,13 @@ void auryn_vector_float_clip(auryn_vector_float * v, const float a );
 void auryn_vector_float_add( auryn_vector_float * a, auryn_vector_float * b);
 /*! Internal  version of to subtract GSL vectors */
 void auryn_vector_float_sub( auryn_vector_float * a, auryn_vector_float * b);
+/*! Adds (a*x[idx[k]])*b to w[offsets[k]] and clips the result at wmax for all k<n. 
+ * The offsets have to be distinct and, like idx, below 2^31. Gathers the operands with AVX2 or AVX-512 
+ * instructions when they are selected (see auryn_set_simd_level) and falls 
+ * back to a scalar loop otherwise. Used for the updates of the weights of a 
+ * row of a BackwardMatrix. */
+void auryn_indexed_saxpy_clip( const float a, const float b, const float * x, const NeuronID * idx, 
+		float * w, const AurynInt * offsets, const float wmax, const NeuronID n );
 
 
 // ushort vector functions